@@ -35,8 +35,8 @@
 #include "ccnsim.h"
 #include "content_distribution.h"
 #include "zipf.h"
-#include <boost/dynamic_bitset.hpp>
 #include <boost/tokenizer.hpp>
+#include <boost/unordered_map.hpp>
 
 
 using namespace std;
@@ -49,14 +49,9 @@ class ShotNoiseContentDistribution : public content_distribution{
 		// http://stackoverflow.com/a/7863971/2110769
 		#endif
 
-		// Functions related to the State Flags (ON/OFF) associated to contents.
-		void set_state_flag(int);
-		void unset_state_flag(int);
-		bool check_state_flag(int);
-
-		// Functions related to the Transition Times associated to each contents.
-		void set_state_time(int, simtime_t);
-		simtime_t get_state_time(int);
+		// ON/OFF process of the contents of the classes with Ton < steadySimTime.
+		bool on_off_class(int);
+		bool is_on(int, name_t, simtime_t);
 
 		// Struct containing useful information associated to each popularity class.
 		struct classInfoEntry
@@ -77,6 +72,7 @@ class ShotNoiseContentDistribution : public content_distribution{
 		};
 
 		vector<classInfoEntry>* classInfo;      // Vector containing information of all the classes.
+		vector<double> classCdf;				// Cumulative percReq of the classes.
 		double totalLambda = 0;					// Aggregated request arrival rate of all the classes.
 		long double totalContents = 0;          // Total number of contents.
 		int numOfClasses = 0;					// Total number of classes.
@@ -102,8 +98,35 @@ class ShotNoiseContentDistribution : public content_distribution{
 
 
 	private:
-		boost::dynamic_bitset<>* state_flags;     	// Vector of State flags (i.e., 1=ON, 0=OFF) per each content.
-		vector<simtime_t>*	state_times;			// Vector of Transition Times per each content.
+		// Content f is ON in the windows [start_k, end_k), k = 0, 1, ..., with
+		// start_0 = 0, end_k - start_k exponential of mean Ton and
+		// start_k+1 = end_k + Toff (Ton and Toff of its class). The k-th ON
+		// duration is the k-th number of the stream of f, so the windows are
+		// generated on demand, in time order, and only the current one is
+		// stored. The contents are grouped in pages of ON_OFF_PAGE contents: the
+		// windows of a page are kept in sparse_windows (one entry per requested
+		// content) until ON_OFF_DENSE of its contents have been requested, then
+		// in an array of ON_OFF_PAGE windows.
+		#pragma pack(push)
+		#pragma pack(1)
+		struct on_window{
+			double end;				// End of the current (or last) ON window.
+			uint32_t k;				// Index of the window.
+		};
+		#pragma pack(pop)
+
+		double on_duration(int, name_t, uint32_t);
+		on_window &window(int, name_t);
+
+		struct on_off_page{
+			on_window *dense;		// Windows of the page (NULL while the page is sparse).
+			uint32_t sparse;		// Windows of the page in sparse_windows.
+		};
+
+		uint64_t on_off_seed;
+		vector<vector<on_off_page> > on_off_pages;		// Pages of each class.
+		boost::unordered_map<name_t, on_window> sparse_windows;	// Windows of the contents of the sparse pages.
+		unsigned long allocated_pages;					// Dense pages.
 
 
 		#ifdef SEVERE_DEBUG
@@ -62,7 +62,7 @@ class WeightedContentDistribution : public content_distribution{
 		virtual void initialize();
 		virtual unsigned short choose_repos (int object_index);
 		virtual void initialize_repo_popularity();
-		virtual vector<unsigned short> binary_strings(int,int);
+		virtual bool independent_placement(){return false;}
 		virtual void finalize_total_replica();
 
 		#ifdef SEVERE_DEBUG
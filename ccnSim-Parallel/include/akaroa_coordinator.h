@@ -0,0 +1,70 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef AKAROA_COORDINATOR_H_
+#define AKAROA_COORDINATOR_H_
+
+#include "coordinator.h"
+
+/*
+ * Coordination through the patched Akaroa master: the observations are sent
+ * with AkObservationMGvect (whole HitMiss windows, parameter 2) and AkObservationMG
+ * (cache sizes, parameter 1), and the master answers with signal 30 (continue)
+ * or 31 (stop). The two signals are blocked and collected with sigwait(), so
+ * that the engine resumes as soon as the verdict arrives.
+ *
+ * Available when ccnSim is built with Akaroa (WITH_AKAROA).
+ */
+class akaroa_coordinator : public coordinator{
+	public:
+		akaroa_coordinator();
+
+		virtual int start(int engines, int num_nodes, int window, int partial_n);
+		virtual bool stable(stability_window &windows, double cv_thr);
+		virtual bool consistent(double measured, double target, double cons_thr);
+
+		// The master does not share the budget: each engine has an equal share.
+		virtual double claim(double chunk);
+		virtual void leave(){;}
+
+		// The streams of the engines are provided by cAkaroaRNG.
+		virtual bool indexed_streams(){return false;}
+
+	private:
+		bool wait_verdict();
+
+		int engines;
+		int num_nodes;
+		int window;
+		int partial_n;
+		double share_left;
+		vector<int> hit_miss;
+};
+#endif
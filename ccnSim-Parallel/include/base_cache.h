@@ -33,6 +33,7 @@
 
 
 #include "ccnsim.h"
+#include "stat_counter.h"
 class DecisionPolicy;
 
 
@@ -105,10 +106,10 @@ class base_cache : public abstract_node{
 
 		void clear_stat();
 
-		virtual uint32_t get_decision_yes();
-		virtual uint32_t get_decision_no();
-		virtual void set_decision_yes(uint32_t n);
-		virtual void set_decision_no(uint32_t n);
+		virtual uint64_t get_decision_yes();
+		virtual uint64_t get_decision_no();
+		virtual void set_decision_yes(uint64_t n);
+		virtual void set_decision_no(uint64_t n);
 		virtual DecisionPolicy* get_decisor() const;
 		virtual void after_discarding_data(); // Call it when you decide not to store an incoming data pkt
 
@@ -121,7 +122,7 @@ class base_cache : public abstract_node{
 
 		virtual bool full() = 0;
 
-		uint32_t decision_yes;
+		stat_counter decision_yes;
 
 		bool stability;
 
@@ -133,11 +134,11 @@ class base_cache : public abstract_node{
 		DecisionPolicy *decisor;
 
 		// Average statistics
-		uint32_t miss;
-		uint32_t hit;
+		stat_counter miss;
+		stat_counter hit;
 
 		//uint32_t decision_yes;
-		uint32_t decision_no;
+		stat_counter decision_no;
 
 
 		// Per file statistics
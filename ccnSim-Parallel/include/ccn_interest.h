@@ -75,20 +75,8 @@ public:
 
 	virtual vector<int> get_repos()
 	{
-	    repo_t repo;
 	    vector<int> repos;
-	    int i;
-
-	    repo = __repo(__id(chunk_var));
-	    i = 0;
-
-	    while (repo)
-	    {
-			if (repo & 1) 
-				repos.push_back(content_distribution::repositories[i]);
-			repo >>= 1;
-			i++;
-	    }
+	    content_distribution::repo_nodes(__id(chunk_var), repos);
 
 		//<aa>
 		#ifdef SEVERE_DEBUG
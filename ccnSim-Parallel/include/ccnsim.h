@@ -25,12 +25,15 @@
 //Clients timers
 #define ARRIVAL 300 	//arrival of a request for the ED scenario
 #define ARRIVAL_TTL 350 //arrival of a request for the ModelGraft scenario
+#define ARRIVAL_SUPERPOSED 360 //aggregate arrival of the clients with superposed arrivals
 #define TIMER 400
 
 //Statistics timers
 #define FULL_CHECK 2000
 #define STABLE_CHECK 3000
 #define CENTRALIZED_STABLE_CHECK 3500
+#define START_ENGINES 3600
+#define PRECISION_CHECK 3700
 #define END 4000
 
 //Strategy Layer messages (mostly for link failure)
@@ -60,7 +63,12 @@ typedef unsigned short filesize_t; //representation for the size part within the
 //              binary string. For a certain content, the i-th bit is 1 if and only if the
 //              content is stored in the i-th repository.
 //</aa>
+//		With more than MAX_BITMASK_REPOS repositories, a repo_t is instead the index
+//		of the replica set in a table shared by all the contents (see
+//		content_distribution::replica_members). Decode it with
+//		content_distribution::for_each_repo() rather than by hand.
 typedef unsigned short repo_t; //representation for the repository part within the catalog entry
+#define MAX_BITMASK_REPOS 16
 //typedef unsigned repo_t; //representation for the repository part within the catalog entry
 
 typedef unsigned long interface_t; //representation of a PIT entry (containing interface information)
@@ -172,8 +180,10 @@ inline chunk_t next_chunk (chunk_t c){
 
 #define __info(f) ( content_distribution::catalog[f].info) //retrieve info about the given content 
 
-#define __size(f)  ( (__info(f) & SIZE_MSK) >> SIZE_OFFSET ) //set the size of a given file
-#define __repo(f)  ( (__info(f) & REPO_MSK) >> REPO_OFFSET )
+//Readers go through content_distribution::file_info(), which also serves
+//procedural catalogs (i.e., computed on demand, see content_distribution.h)
+#define __size(f)  ( (content_distribution::file_info(f) & SIZE_MSK) >> SIZE_OFFSET ) //get the size of a given file
+#define __repo(f)  ( (content_distribution::file_info(f) & REPO_MSK) >> REPO_OFFSET )
 
 #define __ssize(f,s) ( __info(f) = (__info(f) & ~SIZE_MSK ) | s << SIZE_OFFSET )
 #define __srepo(f,r) ( __info(f) = (__info(f) & ~REPO_MSK ) | r << REPO_OFFSET )
@@ -33,7 +33,10 @@
 
 #include <omnetpp.h>
 #include <random>
+#include <boost/unordered_map.hpp>
 #include "ccnsim.h"
+#include "request_trace.h"
+#include "philox_rng.h"
 class statistics;
 class ccn_data;
 using namespace std;
@@ -56,7 +59,13 @@ struct download {
 	#endif
 	//</aa>
 
-    download (double m = 0,simtime_t t = 0):chunk(m),start(t),last(t){;}
+    // Links within the download table of the client (slot indexes, -1 = none).
+    name_t name;
+    int older;			// Deadline list, ordered by 'last'.
+    int newer;
+    int same_name;		// Next download of the same file.
+
+    download (double m = 0,simtime_t t = 0):chunk(m),start(t),last(t),name(0),older(-1),newer(-1),same_name(-1){;}
 };
 
 // Struct used to gather statistics for each single file
@@ -78,6 +87,7 @@ class client : public cSimpleModule {
 		bool stability;
 		double get_avg_distance();
 		double get_tot_downloads();
+		unsigned int get_tot_chunks();
 		simtime_t get_avg_time();
 		bool is_active();
 		void clear_stat();
@@ -100,6 +110,10 @@ class client : public cSimpleModule {
 		double getScheduledReq(int);			// Return the # of scheduled requests for the specified popularity class.
 		double getValidatedReq(int);			// Return the # of validated requests for the specified popularity class.
 
+		// Redraw the pending arrivals after the random streams of the run have been
+		// moved to those of another engine (see philox_rng::set_engine()).
+		virtual void restart_arrivals(){;}
+
 	protected:
 		virtual void initialize();
 		virtual void handleMessage(cMessage *){;};		// It should be implemented by each specialized client.
@@ -112,8 +126,22 @@ class client : public cSimpleModule {
 		void send_interest(name_t, cnumber_t, int);
 		void resend_interest(name_t,cnumber_t,int);
 
-		// List of current downloads for a given file.
-		multimap < name_t, download > current_downloads;
+		void add_download(name_t, const download &);
+
+		// Random stream of the requests of the client (see philox_rng).
+		cRNG *stream(){return philox_rng::module_stream(this);}
+
+		// Current downloads. They are kept in a table of slots, indexed by file
+		// (several downloads of the same file are chained through 'same_name'),
+		// and linked in a deadline list. As the retransmission deadline of a
+		// download is 'last'+RTT and 'last' only moves to the current time, the
+		// list sorted by 'last' is obtained by moving each updated download to its
+		// tail: the stalled downloads are always a prefix of the list.
+		boost::unordered_map < name_t, int > current_downloads;	// First slot of each file.
+		vector<download> download_slots;
+		vector<int> free_slots;
+		int oldest_download;
+		int newest_download;
 
 		#ifdef SEVERE_DEBUG
 		unsigned int interests_sent;
@@ -129,6 +157,9 @@ class client : public cSimpleModule {
 		vector<double> scheduledReq;		// Number of scheduled requests for each popularity class.
 		vector<double> validatedReq;		// Number of validated requests for each popularity class.
 
+		// Trace of the requests of the clients of this partition (see record_trace).
+		static trace_writer recorder;
+
 
     private:
 
@@ -140,5 +171,9 @@ class client : public cSimpleModule {
 		double avg_distance;
 
 		double RTT;
+
+		void unlink_download(int);
+		void append_download(int);
+		void remove_download(int);
 };
 #endif
@@ -35,6 +35,7 @@
 #include <random>
 #include "ccnsim.h"
 #include "client.h"
+#include "zipf_sampled.h"
 
 
 using namespace std;
@@ -42,6 +43,7 @@ using namespace std;
 class client_IRM : public client {
 	public:
 		void extend_sim();
+		virtual void restart_arrivals();
 
     protected:
 		virtual void initialize();
@@ -50,6 +52,9 @@ class client_IRM : public client {
 
 		virtual void request_file(unsigned long);		// For IRM clients the class_num will be always '0' by default.
 
+		void generate_request();
+		void handle_superposed_arrival();
+
     private:
 
 		cMessage *arrival;		// Message to trigger content requests in ED scenario.
@@ -62,6 +67,19 @@ class client_IRM : public client {
 		unsigned long down;
 		double alphaVal;
 
+		zipf_prefetch zipf_requests;	// Prefetched contents of the next requests.
+
+		// With superposed arrivals, the active clients of a partition share a single
+		// Poisson process whose rate is the sum of their rates. It is driven by the
+		// first of them (the leader), which draws the requesting client with
+		// probability proportional to its rate.
+		bool superposed;
+		double request_rate;			// lambda (ED-sim) or lambda/down (ModelGraft).
+		cMessage *arrival_superposed;	// Aggregate arrivals (leader only).
+
+		static vector<client_IRM*> superposed_clients;
+		static vector<double> superposed_cdf;	// Cumulative rates of superposed_clients.
+
 		bool onlyModel = false;		// Avoids the initialization of clients requests in case of model execution.
 };
 #endif
@@ -43,6 +43,7 @@ using namespace std;
 
 class client_ShotNoise : public client {
 	public:
+		virtual void restart_arrivals();
     protected:
 		virtual void initialize(int);				// Multi-stage initialization.
 		int numInitStages() const;
@@ -55,8 +56,8 @@ class client_ShotNoise : public client {
     private:
 		static ShotNoiseContentDistribution* snPointer;		// Pointer to the ShotNoiseContentDistribution class.
 
-		vector<cMessage *> arrivals;		// There is a message for each popularity class in order to trigger the respective
-											// request process.
+		cMessage *arrival;					// Next request, of any class (the class is drawn with probability percReq).
+		double lambdaTotal;					// Request rate of the client for all the classes.
 		cMessage *timer;
 
 		vector<bool> onOffClass;			// Vector indicating which class will be modeled as ON-OFF
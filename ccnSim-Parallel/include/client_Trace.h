@@ -0,0 +1,74 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef CLIENT_TRACE_H_
+#define CLIENT_TRACE_H_
+
+#include <omnetpp.h>
+#include "ccnsim.h"
+#include "client.h"
+#include "request_trace.h"
+
+
+using namespace std;
+
+/*
+ * Client replaying a binary request trace (see request_trace.h): each request
+ * of the trace is issued at its time by the client attached to its node.
+ *
+ * The trace is read once per partition: the first active client (the reader)
+ * maps it, and at each request schedules a single self-message at the time of
+ * the next one, on behalf of the client of that node. Requests of nodes
+ * without a local active client are skipped (in parallel runs they are
+ * issued by the other partitions).
+ */
+class client_Trace : public client {
+	protected:
+		virtual void initialize();
+		virtual void handleMessage(cMessage *);
+		virtual void finish();
+
+		virtual void request_file(unsigned long);
+
+		void replay();
+
+	private:
+		cMessage *arrival;		// Next request of the trace (reader only).
+		cMessage *timer;		// Message to trigger timers.
+
+		static trace_reader reader;
+		static trace_record next_request;
+		static bool pending;						// next_request is valid.
+		static vector<client_Trace*> node_clients;	// Local active client of each node (NULL if none).
+		static unsigned long long replayed;
+		static unsigned long long skipped;
+		static unsigned long long catalog_card;		// Largest content id accepted from the trace.
+};
+#endif
@@ -35,6 +35,7 @@
 #include <random>
 #include "ccnsim.h"
 #include "client.h"
+#include "zipf_sampled.h"
 
 
 using namespace std;
@@ -61,5 +62,7 @@ class client_Window : public client {
 		int currWinSize;		// Current window size.
 		int inFlightPkts; 		// Number of in flight packets.
 		double winTout;		// Time interval to reset the window size
+
+		zipf_prefetch zipf_requests;	// Prefetched contents of the next requests.
 };
 #endif
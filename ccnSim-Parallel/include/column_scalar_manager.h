@@ -0,0 +1,86 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef COLUMN_SCALAR_MANAGER_H_
+#define COLUMN_SCALAR_MANAGER_H_
+
+#include <omnetpp.h>
+#include "result_store.h"
+
+using namespace std;
+#if OMNETPP_VERSION >= 0x0500
+    using namespace omnetpp;
+typedef cIOutputScalarManager scalar_manager_base;
+#else
+typedef cOutputScalarManager scalar_manager_base;
+#endif
+
+/*
+ * Output scalar manager writing the scalars of a run into a binary columnar
+ * result file (see result_store.h) instead of the text .sca file:
+ *
+ *	outputscalarmanager-class = "column_scalar_manager"
+ *	column-scalar-file = ${resultdir}/${configname}-${runnumber}.ccr
+ *
+ * The scalars are kept in memory and written at the end of the run. The
+ * engines forked by the local coordinator exit without ending the run: engine
+ * 0 writes the file, with the results merged over all the engines. Engines
+ * started as independent processes (coordinator = "socket") write each their
+ * own file if ${processid} is in its name; tools/query_results merges the
+ * files of a job and aggregates the results of many runs.
+ */
+class column_scalar_manager : public scalar_manager_base{
+	public:
+		column_scalar_manager():run(0){;}
+		virtual ~column_scalar_manager(){;}
+
+		virtual void startRun();
+		virtual void endRun();
+		virtual void recordScalar(cComponent *component, const char *name, double value, opp_string_map *attributes=NULL);
+		virtual void recordStatistic(cComponent *component, const char *name, cStatistic *statistic, opp_string_map *attributes=NULL);
+		virtual const char *getFileName() const {return file_name.c_str();}
+		virtual void flush(){;}
+
+#if OMNETPP_VERSION >= 0x0500
+		virtual void lifecycleEvent(SimulationLifecycleEventType event_type, cObject *details);
+#endif
+#if OMNETPP_VERSION >= 0x0501
+		virtual void recordParameter(cPar *par){;}
+#endif
+#if OMNETPP_VERSION >= 0x0503
+		virtual void recordComponentType(cComponent *component){;}
+#endif
+
+	private:
+		result_writer results;
+		uint32_t run;
+		string file_name;
+};
+#endif
@@ -31,6 +31,7 @@
 #ifndef CONTENT_DISTRIBUTION_H
 #define CONTENT_DISTRIBUTION_H
 #include <omnetpp.h>
+#include <algorithm>
 #include "ccnsim.h"
 #include "zipf.h"
 #include "zipf_sampled.h"
@@ -53,6 +54,34 @@ struct file{
 
 using namespace std;
 
+// Counter-based stream of the random numbers of a content: the i-th number of
+// content f is a hash (splitmix64 finalizer) of (seed, f, i).
+struct content_stream{
+	uint64_t state;
+	content_stream(uint64_t seed, name_t f):state(seed ^ (0xd1b54a32d192ed03ULL * ((uint64_t)f + 1))){;}
+
+	static uint64_t mix(uint64_t x){
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+	uint64_t next(){
+		return mix(state += 0x9e3779b97f4a7c15ULL);
+	}
+	// i-th number of the stream (counting from 0), without moving along it.
+	uint64_t at(uint64_t i) const{
+		return mix(state + (i + 1) * 0x9e3779b97f4a7c15ULL);
+	}
+	// Uniform integer in [0, j] (multiply-shift instead of a modulo).
+	int bounded(int j){
+		return (int)(((next() >> 32) * (uint64_t)(j + 1)) >> 32);
+	}
+	// Uniform real in (0, 1) from a number of the stream.
+	static double open_unit(uint64_t x){
+		return ((x >> 11) + 0.5) * (1.0/9007199254740992.0);
+	}
+};
+
 
 
 class content_distribution : public cSimpleModule{
@@ -69,13 +98,19 @@ class content_distribution : public cSimpleModule{
 		virtual void verify_replica_number();
 		#endif
 
-		virtual vector<unsigned short> binary_strings(int,int);
+		// True if the placement of a content does not depend on the other
+		// contents, so that the catalog can be initialized in parallel (or
+		// procedurally).
+		virtual bool independent_placement(){return true;}
+		void init_replica_sets();
+
 		int replicas; 				// Number of replicas for each object. If set to -1, the value will be ignored.
 		unsigned long long cardF;
 		unsigned long newCardF; 	// Downscaled  catalog in case of TTL-based scenario.
 
     public:
 		void init_content();
+		unsigned long long get_catalog_card(){return cardF;}
 		int *init_repos(vector<int>);
 		virtual double *init_repo_prices();
 		int *init_clients(vector<int>);
@@ -84,6 +119,14 @@ class content_distribution : public cSimpleModule{
 		static vector<file> catalog;
 		static vector<zipf_sampled*> zipf;
 
+		// With a procedural catalog the entries are not stored: the information
+		// field of content f is computed on demand from a hash of (seed, f).
+		static bool procedural;
+		static info_t procedural_info(name_t f);
+		static inline info_t file_info(name_t f){
+			return procedural ? procedural_info(f) : catalog[f].info;
+		}
+
 		static name_t perfile_bulk;			// Content ID after which per file statistics will not be gathered.
 		static name_t stabilization_bulk; 
 		static name_t cut_off;
@@ -99,9 +142,42 @@ class content_distribution : public cSimpleModule{
 
 		static int num_repos;
 
+		// Replica sets. With up to MAX_BITMASK_REPOS repositories, the repository
+		// field of an entry is a bitmask. With more repositories, it is the index
+		// r of a replica set, whose (sorted) repository indices are
+		// replica_members[r*catalog_replicas ... (r+1)*catalog_replicas-1].
+		static bool repo_table;
+		static vector<unsigned short> replica_members;
+		static unsigned long num_replica_sets;
+
+		// Call f(i) for each repository index i in the replica set r.
+		template<class Fn> static inline void for_each_repo(repo_t r, Fn f){
+			if (repo_table){
+				const unsigned short *m = &replica_members[(size_t)r * catalog_replicas];
+				for (int j = 0; j < catalog_replicas; j++)
+					f(m[j]);
+			} else
+				for (int i = 0; r; r >>= 1, i++)
+					if (r & 1)
+						f(i);
+		}
+
+		// True if the replica set r contains the repository of index repo_idx.
+		static inline bool stores(repo_t r, int repo_idx){
+			if (repo_idx < 0)
+				return false;
+			if (!repo_table)
+				return repo_idx < MAX_BITMASK_REPOS && ((r >> repo_idx) & 1);
+			const unsigned short *m = &replica_members[(size_t)r * catalog_replicas];
+			return std::binary_search(m, m + catalog_replicas, (unsigned short)repo_idx);
+		}
+
+		// Append to 'nodes' the nodes whose repository stores content f.
+		static inline void repo_nodes(name_t f, vector<int> &nodes){
+			for_each_repo(__repo(f), [&nodes](int i){nodes.push_back(repositories[i]);});
+		}
+
     private:
-		vector<unsigned short> repo_strings; 	// Temporary variable used to generate content displacement among repos.
-		
 		int num_clients;
 		int nodes;
 		int F;
@@ -111,5 +187,11 @@ class content_distribution : public cSimpleModule{
 
 		double perc_aggr;
 		double stat_aggr;    // It specifies the percentile of the content catalog for which statistics are gathered.
+
+		// Parameters of the random streams of the contents (see procedural_info()).
+		static uint64_t catalog_seed;
+		static double geometric_scale;				// 1/log(1-1/F), 0 if all the files have size 1.
+		static int catalog_replicas;
+		static int catalog_repos;
 };
 #endif
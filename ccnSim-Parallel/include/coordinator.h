@@ -0,0 +1,172 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef COORDINATOR_H_
+#define COORDINATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "stability_window.h"
+
+/*
+ * Coordination of the engines of the parallel ModelGraft (see statistics):
+ * each engine publishes its observations and blocks until the verdict of the
+ * master, which is the same for all the engines.
+ *	- stable(): windows of the hit ratios of the nodes on the engine (see
+ *	  statistics::centralized_stable); true when the transient is over;
+ *	- consistent(): measured and target cache sizes summed over the active
+ *	  nodes of the engine; true when the MC-TTL cycles can stop.
+ * The steady phase of each MC-TTL cycle can also be shared: the engines claim
+ * chunks of a common budget (claim()) until it is exhausted, so that the
+ * faster engines simulate more of it.
+ *
+ * Implementations:
+ *	"akaroa"	patched Akaroa master (akaroa_coordinator, needs WITH_AKAROA);
+ *	"local"		engines forked by this process (engine_pool);
+ *	"socket"	independent processes and a coordinator daemon reached through
+ *				a Unix domain socket (socket_coordinator, tools/coordinator_daemon).
+ */
+class coordinator{
+	public:
+		virtual ~coordinator(){;}
+
+		// Join the run of 'engines' engines, whose windows have 'window'
+		// samples for each of the 'num_nodes' nodes, 'partial_n' of which must
+		// be stable. Returns the index of the calling engine.
+		virtual int start(int engines, int num_nodes, int window, int partial_n) = 0;
+
+		// Budget of the steady phase of each MC-TTL cycle (simulated time, summed
+		// over the engines), renewed when consistent() starts a new cycle. To be
+		// set before start().
+		void set_budget(double total){budget = total;}
+
+		// Up to 'chunk' of the budget of the current cycle; 0 once exhausted.
+		virtual double claim(double chunk) = 0;
+
+		// Only the summaries changed since the last round are sent, when
+		// possible (see stability_window::take_changes).
+		virtual bool stable(stability_window &windows, double cv_thr) = 0;
+		virtual bool consistent(double measured, double target, double cons_thr) = 0;
+
+		// Number of values that each engine passes to reduce(). To be set before
+		// start().
+		void set_results(size_t values){result_values = values;}
+
+		// Sum of the final results of the engines, left in 'values' of engine 0
+		// (the other engines keep their own). To be called by all the engines
+		// before leave(). False if the results are not merged, i.e., each engine
+		// records its own.
+		virtual bool reduce(std::vector<double> &){return false;}
+
+		// The run is over for this engine.
+		virtual void leave() = 0;
+
+		// True if the engines draw from the streams selected by their index
+		// (see philox_rng::set_engine) rather than from the coordinator.
+		virtual bool indexed_streams(){return true;}
+
+		int stable_nodes(){return last_stables;}	// Of the last stable() round, if known.
+
+	protected:
+		coordinator():last_stables(-1),budget(0),result_values(0){;}
+		int last_stables;
+		double budget;
+		size_t result_values;
+};
+
+/*
+ * Rules of the master, shared by the implementations that do not rely on
+ * Akaroa. They do not depend on OMNeT++.
+ */
+
+// Latest summaries of the nodes of all the engines. A node is stable when it
+// has a window of valid samples in every engine, and its hit ratio over the
+// windows of all the engines has a coefficient of variation below cv_thr
+// (stable with traffic), or when its windows are full in every engine without
+// any valid sample (no traffic).
+class stability_master{
+	public:
+		stability_master():engines(0),num_nodes(0),window(0){;}
+
+		void init(int engines, int num_nodes, int window);
+
+		// False if a record refers to an unknown node.
+		bool update(int engine, const node_summary *records, int count);
+		int stable_nodes(double cv_thr, int &with_traffic) const;
+
+	private:
+		int engines;
+		int num_nodes;
+		int window;
+		std::vector<node_summary> state;	// Node n of engine e at e*num_nodes + n.
+};
+
+// At least partial_n nodes are stable, and at least half of them with traffic.
+bool master_stable(int stables, int with_traffic, int partial_n);
+
+// The measured cache sizes are within cons_thr of the target ones.
+bool master_consistent(double sum_measured, double sum_target, double cons_thr);
+
+/*
+ * Protocol between socket_coordinator and tools/coordinator_daemon. Each
+ * request is a coord_request, followed by 'records' node_summary for
+ * COORD_STABLE, and is answered by a coord_reply.
+ */
+#define COORD_HELLO		1		// value = engine index
+#define COORD_STABLE	2		// verdict, value = stable nodes
+#define COORD_CONSISTENT 3		// verdict
+#define COORD_BYE		4
+#define COORD_CLAIM		5		// amount; answered at once, outside of the rounds
+
+struct coord_request{
+	uint32_t type;
+	uint32_t engines;
+	uint32_t num_nodes;
+	uint32_t window;
+	uint32_t partial_n;
+	uint32_t records;
+	double measured;
+	double target;
+	double threshold;				// cv_thr or cons_thr.
+	double amount;					// Budget (COORD_HELLO) or chunk (COORD_CLAIM).
+};
+
+struct coord_reply{
+	uint32_t verdict;
+	int32_t value;
+	double amount;					// Granted chunk.
+};
+
+// Whole-buffer I/O on a stream socket, retried on EINTR; false on errors or EOF.
+bool write_all(int fd, const void *buf, size_t len);
+bool read_all(int fd, void *buf, size_t len);
+
+#endif
@@ -34,6 +34,7 @@
 
 #include <omnetpp.h>
 #include "ccnsim.h"
+#include "stat_counter.h"
 
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
@@ -136,14 +137,14 @@ class core_layer : public abstract_node{
     private:
 		unsigned long max_pit;
 		unsigned short nodes;
-		unsigned int my_bitmask;
+		int my_repo;		// Index of the attached repository (-1 if none).
 		double my_btw;
 		double RTT;
 
 		static int repo_interest; 	// Total number of Interest packets sent to the attached repository (if present)
 
 		// Number of chunks satisfied by the attached repository (if present).
-		int repo_load; 
+		stat_counter repo_load;
 	
 
 		// Architecture data structures
@@ -152,8 +153,8 @@ class core_layer : public abstract_node{
 		strategy_layer *strategy;
 
 		// Statistics
-		int interests;
-		int data;
+		stat_counter interests;
+		stat_counter data;
 
 		int	send_data (ccn_data* msg, const char *gatename, int gateindex, int line_of_the_call);
 
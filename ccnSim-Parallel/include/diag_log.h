@@ -0,0 +1,111 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef DIAG_LOG_H_
+#define DIAG_LOG_H_
+
+#include <cstdio>
+#include <ostream>
+
+/*
+ * Levels of the diagnostic output. The lines above DIAG_LEVEL are removed at
+ * compile time, e.g. -DDIAG_LEVEL=DIAG_INFO drops the per-node lines.
+ */
+#define DIAG_ERROR	0
+#define DIAG_WARN	1
+#define DIAG_INFO	2
+#define DIAG_DEBUG	3
+
+#ifndef DIAG_LEVEL
+#define DIAG_LEVEL DIAG_DEBUG
+#endif
+
+// Usage: DIAG(DIAG_DEBUG, dbAk) << "NODE # " << n << endl;
+#define DIAG(level, stream) if ((level) > DIAG_LEVEL) ; else (stream)
+
+#define DIAG_SINKS 64		// Files (and the standard output) that can be open at the same time.
+
+/*
+ * Buffered diagnostic stream. A line is formatted in a buffer of the calling
+ * thread and, once complete (i.e., at endl or '\n'), it is queued into the
+ * lock-free ring of the thread; a background thread writes the queued lines
+ * to their files. Therefore, endl does not flush: flush() and close() wait
+ * for the lines queued so far to be written.
+ */
+class diag_stream{
+	public:
+		diag_stream():sink(-1),owned(false){;}
+		explicit diag_stream(FILE *file);		// An already open file, e.g. stdout.
+		~diag_stream(){close();}
+
+		void open(const char *path);
+		void close();
+		void flush();
+		bool is_open() const {return sink >= 0;}
+
+		template <class T>
+		diag_stream &operator<<(const T &value)
+		{
+			if (sink >= 0)
+			{
+				format(sink) << value;
+				committed(sink);
+			}
+			return *this;
+		}
+
+		// Manipulators (endl, setprecision, ...) are applied to the line buffer.
+		diag_stream &operator<<(std::ostream &(*manip)(std::ostream &))
+		{
+			if (sink >= 0)
+			{
+				format(sink) << manip;
+				committed(sink);
+			}
+			return *this;
+		}
+
+		// Writes all the queued lines of every stream (e.g., before an exit).
+		static void flush_all();
+
+	private:
+		diag_stream(const diag_stream &);
+		diag_stream &operator=(const diag_stream &);
+
+		static std::ostream &format(int sink);
+		static void committed(int sink);
+
+		int sink;
+		bool owned;			// The file is closed by close().
+};
+
+// The standard output, through the same buffers.
+extern diag_stream diag_out;
+#endif
@@ -0,0 +1,89 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef ENGINE_POOL_H_
+#define ENGINE_POOL_H_
+
+#include <cstddef>
+#include <sys/types.h>
+#include <vector>
+#include "coordinator.h"
+
+using namespace std;
+
+/*
+ * Local replacement of the Akaroa master for the parallel ModelGraft
+ * (statistics coordinator = "local").
+ *
+ * The engine that has initialized the simulation forks the other engines, so
+ * that all of them share (copy-on-write) the catalog, the Zipf tables, the FIBs
+ * and the caches initialized by the model; each engine then draws from its own
+ * random streams (see philox_rng::set_engine). The engines exchange their
+ * observations (the changed node summaries) through an anonymous MAP_SHARED
+ * segment and meet at a barrier where they sleep on a futex; engine 0 applies
+ * the rules of the master. At the end, the other engines leave their results
+ * on the segment and exit: engine 0 records the sum.
+ */
+class engine_pool : public coordinator{
+	public:
+		engine_pool();
+		~engine_pool();
+
+		// Forks the other engines: 0 is returned to the engine that forked.
+		virtual int start(int engines, int num_nodes, int window, int partial_n);
+
+		virtual bool stable(stability_window &windows, double cv_thr);
+		virtual bool consistent(double measured, double target, double cons_thr);
+		virtual double claim(double chunk);
+
+		// Engine 0 sums the results of all the engines, which it alone records.
+		virtual bool reduce(vector<double> &values);
+
+		// Engine 0 waits for the others, which exit.
+		virtual void leave();
+
+	private:
+		struct board;
+
+		void barrier();
+
+		int engines;
+		int engine;
+		int num_nodes;
+		int window;
+		int partial_n;
+		board *shared;
+		size_t shared_size;
+		pid_t parent;
+		vector<pid_t> children;
+		vector<node_summary> changes;
+		stability_master master;		// Engine 0.
+};
+#endif
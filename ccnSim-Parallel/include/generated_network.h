@@ -0,0 +1,61 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef GENERATED_NETWORK_H_
+#define GENERATED_NETWORK_H_
+
+#include <omnetpp.h>
+#include <string>
+#include "topology_generator.h"
+
+using namespace std;
+#if OMNETPP_VERSION >= 0x0500
+    using namespace omnetpp;
+#endif
+
+/*
+ * Compound module that plays the role of base_network for topologies which are
+ * described by a few parameters (see networks/generated.ned). The node[] and
+ * client[] vectors, together with their links, are created here through
+ * cModuleType::create() instead of being listed in a NED file.
+ */
+class generated_network : public cModule{
+    protected:
+		virtual void doBuildInside();
+
+		virtual void generate(topology_generator &topo);
+		virtual void set_placement(const topology_generator &topo);
+
+		void connect(cModule *a, const char *a_gate, int a_index,
+				cModule *b, const char *b_gate, int b_index, double delay);
+		string full_type_name(const char *type, const char *package);
+		string node_list(const vector<int> &nodes);
+};
+#endif
@@ -0,0 +1,82 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef NETWORK_GRAPH_H_
+#define NETWORK_GRAPH_H_
+
+#include <omnetpp.h>
+#include <vector>
+
+using namespace std;
+#if OMNETPP_VERSION >= 0x0500
+    using namespace omnetpp;
+#endif
+
+/*
+ * Read-only view of the node[] vector of a network as an undirected graph,
+ * stored in compressed adjacency arrays. It is built once (on first use) and
+ * shared by all the modules that need graph algorithms at startup: the routing
+ * service and the betweenness centrality used by the btw decision policy.
+ */
+class network_graph{
+    public:
+		// Shared instance, built on first use from the node[] vector of 'network'.
+		static network_graph *get(cModule *network);
+		static void release();
+
+		int get_num_nodes() const {return num_nodes;}
+		int get_num_links() const {return adj_node.size()/2;}
+
+		// Neighbors of v are adj_node[first(v) .. last(v)-1]; adj_face[] holds the
+		// local face of v that leads to each of them.
+		int first(int v) const {return adj_offset[v];}
+		int last(int v) const {return adj_offset[v+1];}
+		int neighbor(int a) const {return adj_node[a];}
+		int face(int a) const {return adj_face[a];}
+
+		// Betweenness centrality of every node (Brandes' algorithm, unit link
+		// weights), computed with 'threads' threads (0 = all the cores) the first
+		// time it is asked for.
+		const vector<double> &get_betweenness(int threads);
+
+    private:
+		network_graph(cModule *network);
+		void brandes(int first_source, int step, vector<unsigned long long> &partial) const;
+
+		static network_graph *instance;
+
+		int num_nodes;
+		vector<int> adj_offset;
+		vector<int> adj_node;
+		vector<int> adj_face;
+
+		vector<double> betweenness;
+};
+#endif
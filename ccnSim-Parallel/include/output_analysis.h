@@ -0,0 +1,99 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef OUTPUT_ANALYSIS_H_
+#define OUTPUT_ANALYSIS_H_
+
+#include <vector>
+
+using namespace std;
+
+/*
+ * Time series of an output of the simulation (e.g., the hit ratio of the
+ * network over each sampling interval), with the estimators of the output
+ * analysis of a single run.
+ */
+class output_series{
+	public:
+		void add(double value){values.push_back(value);}
+		void clear(){values.clear();}
+		int size() const {return values.size();}
+
+		// MSER-5 truncation point, in samples: the series is grouped in batches
+		// of 5 and the truncation d minimizing the squared standard error of the
+		// mean of the remaining batches is chosen among the first half of the
+		// batches. -1 if there are less than min_batches batches, or if the
+		// minimum falls in the second half (the series is still in its transient).
+		int mser5(int min_batches) const;
+
+		// Batch-means confidence interval of the mean: the series is split in
+		// 'batches' batches of equal size (the oldest samples in excess are
+		// dropped). False if there are less samples than batches.
+		bool batch_means(int batches, double confidence, double &mean, double &half_width) const;
+
+	private:
+		vector<double> values;
+};
+
+/*
+ * In-engine output analysis of the hit ratio (statistics, ci_precision > 0):
+ * the transient is over when MSER-5 finds its truncation point, and the
+ * steady phase is over when the batch-means confidence interval of the mean
+ * reaches the requested relative precision. Series 0 is the hit ratio of the
+ * network; series 1..num_nodes, if checked, are the hit ratios of the nodes,
+ * of which only those with samples (i.e., with traffic) are evaluated.
+ */
+class output_analysis{
+	public:
+		output_analysis():batches(20),confidence(0.95),per_node(false){;}
+
+		void init(int num_nodes, int batches, double confidence, bool per_node);
+		void clear();
+
+		output_series &network(){return series[0];}
+		output_series &node(int n){return series[n+1];}
+		bool nodes_checked() const {return per_node;}
+
+		// Truncation point of the network series, -1 while in the transient.
+		int warm_up() const;
+
+		// The relative half-width of the checked series is below 'precision'.
+		bool precise(double precision) const;
+
+		// Estimate of the network series (false if not available).
+		bool estimate(double &mean, double &half_width) const;
+
+	private:
+		vector<output_series> series;
+		int batches;
+		double confidence;
+		bool per_node;
+};
+#endif
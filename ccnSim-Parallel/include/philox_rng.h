@@ -0,0 +1,133 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef PHILOX_RNG_H_
+#define PHILOX_RNG_H_
+
+#include <omnetpp.h>
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+#if OMNETPP_VERSION >= 0x0500
+    using namespace omnetpp;
+#endif
+
+#if OMNETPP_VERSION >= 0x0500
+typedef uint32_t rng_word_t;
+#else
+typedef unsigned long rng_word_t;
+#endif
+
+/*
+ * Counter-based random number generator (Philox4x32-10, Salmon et al., SC'11).
+ *
+ * The n-th output block of a stream is a pure function of (key, n): a stream
+ * needs no state besides its position, and any number of independent streams
+ * is obtained without coordination by changing the key. Here the key is made
+ * of the seed set and of a stream number, and the upper half of the counter
+ * holds the 64-bit identifier of the owner of the stream.
+ *
+ * As the OMNeT++ rng-class (rng-class = "philox_rng") every global RNG of an
+ * engine is keyed by (seed set, parsim partition, RNG index). Moreover, each
+ * component gets its own stream, keyed by its full path, from module_stream():
+ * as the draws of a component do not depend on the events of the others, the
+ * workload (arrivals and requested contents of the clients) is the same in
+ * sequential runs and with any number of parsim partitions. With any other
+ * rng-class, module_stream() simply returns the RNG 0 of the component.
+ *
+ * Replicas of the same run (the engines of the parallel ModelGraft, see
+ * engine_pool) are told apart by an engine index, which is also part of the
+ * key of all the streams.
+ *
+ * Outputs are generated in batches of PHILOX_BATCH blocks.
+ */
+#define PHILOX_BATCH 16
+
+class philox_rng : public cRNG{
+	public:
+		philox_rng();
+		philox_rng(int seed_set, uint64_t id, uint32_t stream = 0);
+
+		virtual void initialize(int seedSet, int rngId, int numRngs, int parsimProcId,
+				int parsimNumPartitions, cConfiguration *cfg);
+		virtual void selfTest();
+
+		virtual ~philox_rng();
+
+		virtual unsigned long getNumbersDrawn() const {return drawn;}
+		virtual rng_word_t intRand();
+		virtual rng_word_t intRandMax() {return 0xffffffffUL;}
+		virtual rng_word_t intRand(rng_word_t n);
+		virtual double doubleRand();
+		virtual double doubleRandNonz();
+		virtual double doubleRandIncl1();
+
+		// Stream of component 'c' (its RNG 0 if philox_rng is not the rng-class).
+		static cRNG *module_stream(cComponent *c);
+
+		// Move all the streams of this process to those of engine 'e'. Returns
+		// false if philox_rng is not the rng-class.
+		static bool set_engine(int e);
+
+		// Philox4x32-10 bijection of 'ctr' under 'key' (in place).
+		static void block(uint32_t ctr[4], const uint32_t key[2]);
+
+	private:
+		void set_key(int seed_set, uint64_t id, uint32_t stream);
+		void refill();
+
+		uint32_t key[2];
+		uint64_t id;
+		uint32_t stream;
+		int seed;
+		uint64_t position;						// Next block to be generated.
+		uint32_t buffer[4*PHILOX_BATCH];
+		unsigned next;							// Next word of buffer.
+		unsigned long drawn;
+
+		static bool active;						// philox_rng is the rng-class of the run.
+		static int seed_set;
+		static int engine;
+		static vector<philox_rng*> streams;		// Component streams, by component id.
+		static vector<philox_rng*> engine_rngs;	// Global RNGs of the run.
+};
+
+/*
+ * Exponential variate drawn from 'rng' (the same transformation as the
+ * exponential() of OMNeT++, for any cRNG).
+ */
+inline double rng_exponential(cRNG *rng, double mean)
+{
+	return -mean * log(1.0 - rng->doubleRand());
+}
+
+#endif
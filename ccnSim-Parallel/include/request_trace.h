@@ -0,0 +1,109 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef REQUEST_TRACE_H_
+#define REQUEST_TRACE_H_
+
+#include <cstdio>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+/*
+ * Binary request traces: the sequence of the requests (time, client, content)
+ * issued by the clients of a run, recorded by client (see record_trace in
+ * clients.ned) and replayed by client_Trace.
+ *
+ * A trace starts with the 8-byte magic TRACE_MAGIC and is followed by one
+ * record per request, made of three LEB128 varints: the time elapsed since
+ * the previous record (in nanoseconds), the index of the node of the client,
+ * and the content. Records must be in non-decreasing time order.
+ *
+ * The codec does not depend on OMNeT++, so that the off-line tools can use it
+ * (see tools/convert_trace.cc).
+ */
+#define TRACE_MAGIC "CCNTRC1\n"
+#define TRACE_MAGIC_LEN 8
+
+struct trace_record{
+	double time;					// Seconds.
+	int client;						// Index of the node of the client.
+	unsigned long long content;
+};
+
+class trace_writer{
+	public:
+		trace_writer():file(NULL),last_ns(0),count(0){;}
+		~trace_writer(){close();}
+
+		void open(const char *path);
+		void append(double time, int client, unsigned long long content);
+		void close();
+		bool is_open(){return file != NULL;}
+		unsigned long long records(){return count;}
+
+	private:
+		void put(unsigned long long v);
+		void flush();
+
+		FILE *file;
+		vector<unsigned char> buffer;		// Encoded records not yet written.
+		unsigned long long last_ns;
+		unsigned long long count;
+};
+
+/*
+ * The trace is memory-mapped and read sequentially. The kernel is told to read
+ * ahead the next window (TRACE_WINDOW bytes) and to drop the window before the
+ * previous one, so that the resident part of the trace stays bounded.
+ */
+#define TRACE_WINDOW (8UL << 20)
+
+class trace_reader{
+	public:
+		trace_reader():data(NULL),size(0),pos(0),last_ns(0),advised(0){;}
+		~trace_reader(){close();}
+
+		void open(const char *path);
+		bool next(trace_record &r);			// False at the end of the trace.
+		void close();
+
+	private:
+		bool get(unsigned long long &v);
+		void read_ahead();
+
+		const unsigned char *data;
+		size_t size;
+		size_t pos;
+		unsigned long long last_ns;
+		size_t advised;						// End of the window already advised.
+};
+#endif
@@ -0,0 +1,138 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef RESULT_STORE_H_
+#define RESULT_STORE_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+/*
+ * Binary columnar result files: the scalars of one or more runs as rows
+ * (run, module, node, metric, value), written by column_scalar_manager and
+ * read, merged and aggregated by tools/query_results.
+ *
+ * Runs, modules and metrics are strings stored once in the dictionaries of
+ * the file; the node is the index of the scalar name, e.g. 3 for "p_hit[3]"
+ * whose metric is "p_hit" (-1 when the name has no index). The rows are
+ * sorted by (metric, run, module, node) and cut into blocks of RESULT_BLOCK
+ * rows; each block stores its columns one after the other:
+ *
+ *	value (double), run, module, metric (uint32_t), node (int32_t)
+ *
+ * After the blocks, the footer holds the dictionaries and the index of the
+ * blocks (offset, rows, range of the runs and of the metrics), so that a
+ * reader only visits the blocks of the metrics and runs it looks for. The
+ * file ends with the offset of the footer and RESULT_MAGIC. Numbers are in the
+ * byte order of the host that wrote the file.
+ */
+#define RESULT_MAGIC "CCNRES1\n"
+#define RESULT_MAGIC_LEN 8
+#define RESULT_BLOCK 8192
+
+struct result_block{
+	uint64_t offset;
+	uint32_t rows;
+	uint32_t run_min, run_max;
+	uint32_t metric_min, metric_max;
+};
+
+// Strings numbered in order of insertion.
+class result_dictionary{
+	public:
+		uint32_t id(const string &s);
+		int find(const string &s) const;		// -1 if absent.
+		const string &name(uint32_t id) const {return names[id];}
+		uint32_t size() const {return names.size();}
+
+	private:
+		friend class result_reader;
+		vector<string> names;
+		unordered_map<string, uint32_t> ids;
+};
+
+class result_writer{
+	public:
+		void add(const string &run, const string &module, const string &scalar, double value);
+		void add(uint32_t run, uint32_t module, int32_t node, uint32_t metric, double value);
+		void write(const char *path);
+		void clear();
+		size_t size() const {return values.size();}
+
+		result_dictionary runs, modules, metrics;
+
+	private:
+		vector<double> values;
+		vector<uint32_t> run_col, module_col, metric_col;
+		vector<int32_t> node_col;
+};
+
+/*
+ * The file is memory-mapped; the columns of a block are read in place.
+ */
+class result_reader{
+	public:
+		result_reader():data(NULL),size(0){;}
+		~result_reader(){close();}
+
+		void open(const char *path);
+		void close();
+
+		const result_dictionary &runs() const {return run_dict;}
+		const result_dictionary &modules() const {return module_dict;}
+		const result_dictionary &metrics() const {return metric_dict;}
+
+		unsigned blocks() const {return index.size();}
+		const result_block &block(unsigned b) const {return index[b];}
+		const double *value_column(unsigned b) const;
+		const uint32_t *run_column(unsigned b) const;
+		const uint32_t *module_column(unsigned b) const;
+		const uint32_t *metric_column(unsigned b) const;
+		const int32_t *node_column(unsigned b) const;
+
+	private:
+		void read_dictionary(size_t &pos, result_dictionary &dict);
+		void corrupted(size_t pos);
+
+		string path;
+		const unsigned char *data;
+		size_t size;
+		result_dictionary run_dict, module_dict, metric_dict;
+		vector<result_block> index;
+};
+
+// Splits "p_hit[3]" into ("p_hit", 3), and "p_hit" into ("p_hit", -1).
+void split_scalar_name(const string &scalar, string &metric, int32_t &node);
+#endif
@@ -0,0 +1,80 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef ROUTING_SERVICE_H_
+#define ROUTING_SERVICE_H_
+
+#include <omnetpp.h>
+#include <vector>
+#include <string>
+
+using namespace std;
+#if OMNETPP_VERSION >= 0x0500
+    using namespace omnetpp;
+#endif
+
+class network_graph;
+
+/*
+ * Shortest path (hop count) routing computed once for the whole network and
+ * shared by all the strategy layers, as an alternative to running cTopology
+ * inside every node (see strategy_layer::populate_routing_table). One BFS is run
+ * on the shared network_graph for each destination, so that the total cost is
+ * O(|D|*(N+E)) instead of O(N*|D|*E*log N). Destinations can be restricted to
+ * the repositories, which is what spr, random_repository and parallel_repository
+ * need, in order to keep the memory footprint linear in the network size for
+ * very large topologies.
+ */
+class routing_service{
+    public:
+		// Shared instance, built on first use from the node[] vector of 'network'.
+		// 'destinations' is either "all" or "repos".
+		static routing_service *get(cModule *network, const string &destinations);
+		static void release();
+
+		const vector<int> &get_destinations() const {return destinations;}
+
+		// Faces of 'node' that lie on a shortest path towards 'dest'. The return
+		// value is the distance in hops, or -1 if 'dest' cannot be reached.
+		int next_hops(int node, int dest, vector<int> &faces) const;
+
+    private:
+		routing_service(cModule *network, const string &destinations);
+		void bfs(int dest, vector<unsigned short> &dist) const;
+
+		static routing_service *instance;
+
+		const network_graph *graph;
+
+		vector<int> destinations;
+		vector<int> dest_slot;		// Position of a node within 'destinations' (-1 if it is not a destination)
+		vector<vector<unsigned short> > dist;	// dist[slot][v]: hops from v to destinations[slot]
+};
+#endif
@@ -0,0 +1,70 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef SOCKET_COORDINATOR_H_
+#define SOCKET_COORDINATOR_H_
+
+#include <string>
+#include "coordinator.h"
+
+using namespace std;
+
+/*
+ * Coordination through tools/coordinator_daemon: each engine is an
+ * independent process (e.g., started by a script on the same host), connected
+ * to the daemon through a Unix domain socket. The engine blocks on the socket
+ * until the daemon has received the observations of all the engines, so it
+ * resumes as soon as the verdict is sent.
+ *
+ * The daemon assigns the engine indexes in order of connection.
+ */
+class socket_coordinator : public coordinator{
+	public:
+		socket_coordinator(const string &path);
+		~socket_coordinator();
+
+		virtual int start(int engines, int num_nodes, int window, int partial_n);
+		virtual bool stable(stability_window &windows, double cv_thr);
+		virtual bool consistent(double measured, double target, double cons_thr);
+		virtual double claim(double chunk);
+		virtual void leave();
+
+	private:
+		coord_reply request(coord_request &req, const node_summary *records = NULL);
+
+		string path;
+		int fd;
+		int engines;
+		int num_nodes;
+		int window;
+		int partial_n;
+		vector<node_summary> changes;
+};
+#endif
@@ -0,0 +1,101 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef STABILITY_WINDOW_H_
+#define STABILITY_WINDOW_H_
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/*
+ * Compact record of the state of a node on an engine, exchanged with the
+ * master of the parallel ModelGraft (see coordinator.h): Welford summary of
+ * the hit ratios sampled in the current window of the node.
+ */
+struct node_summary{
+	int32_t node;
+	uint32_t count;		// Valid samples (i.e., of a node with traffic) in the window.
+	uint32_t taken;		// Samples in the window, valid or not.
+	double mean;
+	double m2;			// Sum of the squared deviations from the mean.
+};
+
+/*
+ * Sliding windows of the (cumulative) hit and miss counters of the nodes,
+ * sampled every Ts by statistics::centralized_stable. Each node keeps its
+ * last 'window' samples and their running summary, so that the samples are
+ * not lost when the master asks for another stable check: only the summaries
+ * changed since the last check are sent, one node_summary per node.
+ *
+ * It does not depend on OMNeT++.
+ */
+class stability_window{
+	public:
+		stability_window():num_nodes(0),window(0){;}
+
+		void init(int num_nodes, int window);
+
+		// A new sample of 'node'; hit = miss = 0 for a node without traffic,
+		// which fills the window but is not a valid sample.
+		void add(int node, int64_t hit, int64_t miss);
+
+		bool full(int node) const {return taken[node] >= window;}
+		int full_nodes() const;
+
+		// Drop all the samples (e.g., the Tc of the caches have changed).
+		void reset();
+
+		// Appends the summaries changed since the last call.
+		void take_changes(vector<node_summary> &records);
+
+		// The windows in the HitMiss layout of the Akaroa master: the hit
+		// counters of node n at [n*window, (n+1)*window), oldest first, then the
+		// miss counters; -1 marks a sample not collected.
+		void hit_miss(int *out) const;
+
+		int nodes() const {return num_nodes;}
+		int size() const {return window;}
+
+	private:
+		void mark(int node);
+		void recompute(int node);
+
+		int num_nodes;
+		int window;
+		vector<int64_t> hits;			// Ring of the samples of node n at [n*window, (n+1)*window).
+		vector<int64_t> misses;
+		vector<int> taken;				// Samples taken by each node.
+		vector<node_summary> summary;
+		vector<char> changed;
+		vector<int> changed_nodes;
+};
+#endif
@@ -0,0 +1,103 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef STAT_COUNTER_H_
+#define STAT_COUNTER_H_
+
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+
+using namespace std;
+
+#ifndef STAT_SHARDS
+#define STAT_SHARDS 8				// Threads that can update the counters.
+#endif
+#define STAT_PAGE_SLOTS 512			// Counters per page (4kB per shard).
+
+class stat_counter;
+
+/*
+ * Registry of the event counters of the nodes (hits, misses and caching
+ * decisions of the caches, Interest and Data packets of the core layers).
+ *
+ * Each counter has a slot in every shard, and each thread updates only the
+ * slot in its own shard: the shards are allocated in separate pages, so that
+ * two threads never write into the same cache line. The value of a counter
+ * is the sum of its slots, and snapshot() reduces all of them at once.
+ * The counters are 64-bit, so that long runs do not wrap around.
+ */
+class stat_registry{
+	public:
+		static void attach(stat_counter &counter);
+		static void detach(stat_counter &counter);
+
+		// Value of every counter, indexed by stat_counter::slot().
+		static void snapshot(vector<uint64_t> &values);
+
+		// Shard of the calling thread.
+		static int shard()
+		{
+			static thread_local int own_shard = next_shard();
+			return own_shard;
+		}
+
+	private:
+		static int next_shard();
+
+		static vector<uint64_t *> pages[STAT_SHARDS];
+		static vector<unsigned> free_slots;
+		static unsigned slots;
+		static atomic<int> threads;
+};
+
+class stat_counter{
+	public:
+		stat_counter(){stat_registry::attach(*this);}
+		~stat_counter(){stat_registry::detach(*this);}
+
+		void operator++(int){++*cell[stat_registry::shard()];}
+		stat_counter &operator+=(uint64_t n){*cell[stat_registry::shard()] += n; return *this;}
+
+		uint64_t value() const;		// Sum over the shards.
+		void set(uint64_t n);
+		void clear(){set(0);}
+
+		unsigned slot() const {return id;}
+
+	private:
+		friend class stat_registry;
+		stat_counter(const stat_counter &);
+		stat_counter &operator=(const stat_counter &);
+
+		unsigned id;
+		uint64_t *cell[STAT_SHARDS];	// Slot of the counter in each shard.
+};
+#endif
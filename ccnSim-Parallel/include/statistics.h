@@ -41,6 +41,10 @@
 #include <vector>
 #include <chrono>
 #include <fstream>
+#include "coordinator.h"
+#include "output_analysis.h"
+#include "stat_counter.h"
+#include "diag_log.h"
 
 
 class client;
@@ -85,9 +89,12 @@ class statistics : public cSimpleModule{
 		virtual void handleMessage(cMessage *);
 		virtual void finish();
 
-		virtual void centralized_stable(int);		// Collect only valid samples for the HitMiss vector to be sent to the Master.
+		virtual void centralized_stable(int);		// Collect only valid samples for the windows sent to the Master.
+		void sample_hit_ratios();					// Hit ratios over the last Ts, for the output analysis.
 
 		void clear_stat();		// Each component (cache, client, etc) is asked to clear its statistics.
+		void collect_results(vector<double> &);		// Final results of the engine (see finish()).
+		void merge_results();						// Sum the results of the engines before they leave.
 	
 		void stability_has_been_reached();
 
@@ -100,6 +107,7 @@ class statistics : public cSimpleModule{
 		cMessage *centralized_stable_check;		// Scheduled message to check for the stability in a centralized way
 												// (i.e., it is the master that receives measures and that decides).
 		cMessage *end;
+		cMessage *precision_check;				// Scheduled message to check the precision of the steady-state estimate.
 
 		//	Vectors to access statistics of the different modules.
 		client** clients;
@@ -131,11 +139,14 @@ class statistics : public cSimpleModule{
 		//	Stabilization samples
 		vector< vector <double> > samples;
 		vector<double> events; 	// Takes track of the changes (hit or miss) of each node.
+
+		// Counters of the nodes reduced over the shards (see stat_registry).
+		vector<uint64_t> counters;
+		uint64_t count(const stat_counter &c) const {return counters[c.slot()];}
 		vector<bool> stable_nodes;
 		vector<bool> stable_with_traffic_nodes; // Takes track of those stable nodes that have received traffic
 
-		vector<int> sample_counter;		// It takes trace of the collected samples;
-										// When sample_counter=sizeVect for each node, measures are sent to the master.
+		stability_window hit_windows;	// Last engineWindow Hit and Miss samples of each node, sent to the master.
 
 		int num_threads;			// Number of threads used for parallel simulations
 		double engineWindow;    // It is the size of the window assigned to each engine (i.e., window/num_cores)
@@ -162,14 +173,24 @@ class statistics : public cSimpleModule{
 		int sim_cycles = 1; 			// Track the number of simulation cycles
 		bool dynamic_tc = true;
 
+		// Coordination of the engines (see coordinator.h).
+		coordinator *coord;
+		int budget_chunks;				// The steady phase is shared among the engines in chunks of time_steady/budget_chunks (0 = disabled).
+		double steady_claimed;			// Steady time simulated by this engine in the current MC-TTL cycle.
+		vector<double> merged_results;	// Results summed over the engines, recorded by finish() (engine 0 of local engines).
+
 		// Debug with Akaroa
-		ofstream dbAk;
+		diag_stream dbAk;
 		const char* debugFilePath;
-		// Sending statistics to Akaroa master
-		int *HitMiss;
-		int sizeVect;
 
 		double cvThr;                   // Threshold to compare the Coefficient of Variation (CV) against.
+
+		// In-engine output analysis (single engine): MSER-5 truncation of the transient,
+		// and steady phase ended by the batch-means confidence interval of the hit ratio.
+		double ci_precision;			// Relative half-width to be reached (0 = disabled).
+		output_analysis analysis;
+		vector<uint64_t> analysis_hit;		// Counters of the caches at the previous sample.
+		vector<uint64_t> analysis_miss;
         double consThr;                 // Consistency Check threshold; (default = 0.1)
 
 };
@@ -67,7 +67,7 @@ class strategy_layer: public abstract_node{
 
 		static ifstream fdist;
 		static ifstream frouting;
-		const vector<int_f> get_FIB_entries(int destination_node_index);
+		const vector<int_f> &get_FIB_entries(int destination_node_index);
 		int get_out_interface(int destination_node);
     protected:
 		virtual void initialize();
@@ -75,6 +75,7 @@ class strategy_layer: public abstract_node{
 
 		void populate_routing_table();
 		void populate_from_file();
+		void populate_from_routing_service();
 
 		void add_FIB_entry(int destination_node_index, int interface_index,	int distance);
 		virtual vector<int> choose_paths(int num_paths)=0;
@@ -0,0 +1,124 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef TOPOLOGY_GENERATOR_H_
+#define TOPOLOGY_GENERATOR_H_
+
+#include <vector>
+#include <random>
+#include <unordered_set>
+#include <unordered_map>
+#include <string>
+#include <fstream>
+#include "error_handling.h"
+
+using namespace std;
+
+/*
+ * Builds the edge list of a network topology from a handful of parameters,
+ * so that large topologies do not need to be written (and parsed) as NED files.
+ * Nodes are identified by 0..get_num_nodes()-1; every undirected link appears
+ * exactly once in get_edges(). Both time and memory are linear in the number
+ * of edges. The class does not depend on the OMNeT++ kernel, which makes it
+ * usable also by the off-line tools.
+ */
+class topology_generator{
+    public:
+		topology_generator(unsigned long seed);
+
+		// Complete k-ary tree with 'depth' levels below the root (node 0). Node i
+		// has children arity*i+1 .. arity*i+arity. With probability extra_prob each
+		// non-root internal node is also linked to every child of its siblings, as
+		// done by scripts/createTreeTopo_withVarConnectivity.sh for the tree_res networks.
+		void k_ary_tree(int arity, int depth, double extra_prob);
+
+		// rows x cols grid; node r*cols+c. If torus is true, borders wrap around.
+		void grid(int rows, int cols, bool torus);
+
+		// Random d-regular graph (no self loops, no parallel links).
+		void random_regular(int nodes, int degree);
+
+		// Barabasi-Albert preferential attachment: every new node brings m links,
+		// starting from a clique of m+1 nodes.
+		void barabasi_albert(int nodes, int m);
+
+		// Edge list file, one "u v" pair per line; lines starting with '#' are skipped.
+		// Node ids are used as they are (node[u] is node u of the file).
+		void edge_list(const char *file_name);
+
+		// Importers for real topologies. Files are read in a single pass and node
+		// labels (which may be arbitrary strings) are mapped to 0..N-1 in order of
+		// first appearance; get_label() gives back the original label.
+		//  - labelled_edge_list: "label1 label2 [anything else]" per line
+		//  - graphml: <node id=".."/> and <edge source=".." target=".."/> elements
+		//  - rocketfuel: .cch router-level maps; external (negative uid) nodes are skipped
+		void labelled_edge_list(const char *file_name);
+		void graphml(const char *file_name);
+		void rocketfuel(const char *file_name);
+		void import(const char *file_name, const string &format);
+
+		int get_num_nodes() const {return num_nodes;}
+		const vector<pair<int,int> > &get_edges() const {return edges;}
+		vector<int> get_degrees() const;
+
+		// Nodes where clients and repositories are placed when the ini file does not
+		// say otherwise (e.g. leaves and root of a tree). Empty vectors mean that the
+		// usual random placement of content_distribution applies.
+		const vector<int> &get_default_clients() const {return default_clients;}
+		const vector<int> &get_default_repos() const {return default_repos;}
+
+		// Select nodes according to a placement rule:
+		//  - stub: nodes with a single link (the first 'count' of them, or all if count is 0)
+		//  - low_degree / high_degree: the 'count' nodes with the lowest / highest degree
+		// Ties are broken by node id, so that the placement is deterministic.
+		vector<int> select_nodes(const string &rule, int count) const;
+
+		string get_label(int node) const {return labels.empty() ? to_string(node) : labels[node];}
+
+    protected:
+		void clear();
+		void reset(int nodes);
+		bool add_edge(int u, int v);	// Returns false if the link would be a self loop or a duplicate.
+		int node_id(const string &label);	// Id of a labelled node, created on first use.
+		void open(ifstream &in, const char *file_name);
+
+		int num_nodes;
+		vector<pair<int,int> > edges;
+		unordered_set<unsigned long long> edge_set;
+
+		unordered_map<string,int> label_map;
+		vector<string> labels;
+
+		vector<int> default_clients;
+		vector<int> default_repos;
+
+		std::mt19937_64 rng;
+};
+#endif
@@ -44,6 +44,12 @@ class zipf_distribution{
 		zipf_distribution(){zipf_distribution(0,0);}
 		void zipf_initialize();
 
+		// Keep the cdf in single precision (to be called before zipf_initialize()).
+		// It saves memory for large multi-class catalogs, but contents whose
+		// cumulative probabilities are not distinguishable in single precision
+		// collapse on the first of them.
+		void set_compact_cdf(bool c){compact = c;}
+
 		// 	Return the index of the content y such that the the sum of the
 		//	probabilities of contents from 0 to y is >= p
 		unsigned int value (double p);
@@ -58,6 +64,13 @@ class zipf_distribution{
 
     private:
 		vector<double> cdfZipf;
+		vector<float> cdfCompact;			// Replaces cdfZipf with set_compact_cdf(true).
+		vector<unsigned int> guide;			// guide[i] is the first content whose cdf is >= i/guide.size().
+		bool compact = false;
+
+		template<class T> void build_cdf(vector<T> &cdf);
+		template<class T> void build_guide(const vector<T> &cdf);
+		template<class T> unsigned int guided_search(const vector<T> &cdf, double p);
 		double alpha;
 		double q;
 		int F;
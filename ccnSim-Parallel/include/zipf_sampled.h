@@ -43,6 +43,9 @@
 
 
 using namespace std;
+#if OMNETPP_VERSION >= 0x0500
+    using namespace omnetpp;
+#endif
 
 /**
 * 
@@ -84,6 +87,14 @@ class zipf_sampled {
         unsigned long down;							// Downscaling factor;
         unsigned long long newCard;						// Downscaled cardinality;
 
+        vector<double> batch_u;						// Scratch arrays of the batched sampler.
+        vector<double> batch_x;
+
+        vector<double> bin_prob;					// Alias table over the meta-contents (built on first use).
+        vector<unsigned long> bin_alias;
+
+        void build_bin_table();
+
 
     public:
 
@@ -111,21 +122,20 @@ class zipf_sampled {
             hIntegralX1 = hIntegral(1.5) - 1.0;
             hIntegralNumberOfElements = hIntegral((double)numberOfElements + 0.5);
             s = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2));
-            /** IMPORTANT **
-             *  If the catalog is bigger than 1e9, the computation of the normalization_constant takes a lot of time.
-             *  So, if it is the case, we avoid computing that, since it is not used from zipf_sampled, and we set
-             *  normalization_constant = 1. This variable is used by the following functions (which are not used in ModelGraftExecution):
-             *  - WeightedContentDistribution.cc
-             *  - cacheFillNaive() in statistics.cc
-             *  - cacheFillModel_Scalable_Approx() in statistics.cc
-             *  - calculate_phit_neigh_scalable() in statistics.cc
-             *  - cacheFillModel_Scalable_Approx_NRR() in statistics.cc
-             *  - calculate_phit_neigh() in statistics.cc
-             */
-            if(newCard*down <= pow(10.0,9.0))
-            	normalization_constant = generalizedHarmonic(newCard*down, exponent);
-            else
-            	normalization_constant = 1;
+            // Closed form (see harmonicSum()), so that it is available for catalogs of any size.
+            normalization_constant = generalizedHarmonic(newCard*down, exponent);
+            #ifdef SEVERE_DEBUG
+            if(newCard*down <= 100000000ULL)
+            {
+            	double exact = generalizedHarmonicExact(newCard*down, exponent);
+            	if(abs(normalization_constant - exact) > 1e-10*exact)
+            	{
+            		std::stringstream ermsg;
+            		ermsg<<"Generalized harmonic number: closed form "<<normalization_constant<<", exact "<<exact;
+            		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+            	}
+            }
+            #endif
             normalization_constant  = 1.0*(1./normalization_constant);
         }
         zipf_sampled(unsigned long long numOfElem, double alpha):numberOfElements(numOfElem),exponent(alpha){;};
@@ -133,7 +143,7 @@ class zipf_sampled {
 
 
         /**
-        * Calculates the Nth generalized harmonic number.
+        * Calculates the Nth generalized harmonic number in O(1) (see harmonicSum()).
         *
         * @param n Term in the series to calculate (must be larger than 1)
         * @param m Exponent (special case (m = 1) is the harmonic series).
@@ -141,6 +151,20 @@ class zipf_sampled {
         */
         double generalizedHarmonic(unsigned long long content, double alpha);
 
+        /**
+        * Reference value of the Nth generalized harmonic number, obtained by adding
+        * up all the terms (smallest first, with compensated summation) with the
+        * given number of threads (0 = all the cores). The result does not depend
+        * on the number of threads.
+        */
+        double generalizedHarmonicExact(unsigned long long content, double alpha, unsigned int threads = 0);
+
+        /**
+        * Sum of 1/k^m for k in [a, b]: the first terms are added up, the rest is
+        * evaluated with the Euler-Maclaurin formula (relative error below 1e-12).
+        */
+        double harmonicSum(unsigned long long a, unsigned long long b, double m);
+
 
         /** Generate one integral number in the range [1, numberOfElements].
          * @param random random generator to use
@@ -148,6 +172,24 @@ class zipf_sampled {
          */
         unsigned long long sample();
 
+        /** Generate 'count' integral numbers in the range [1, numberOfElements]
+         * drawing from 'rng', in the same order as 'count' calls of sample().
+         * The candidates of the whole batch are drawn, inverted and tested in
+         * separate loops, and only the rejected candidates are drawn again.
+         * @param rng random generator to use
+         * @param out array of at least 'count' elements
+         */
+        void sample(cRNG *rng, unsigned long long *out, unsigned int count);
+
+        /** Generate 'count' meta-contents of the downscaled catalog, i.e., the
+         * values floor(k/down)+1 of integral numbers k in [1, numberOfElements],
+         * without sampling k: each meta-content is drawn in O(1) from an alias
+         * table built on the masses of the bins (one random number per value).
+         * @param rng random generator to use
+         * @param out array of at least 'count' elements, filled with values in [1, newCard]
+         */
+        void sample_meta(cRNG *rng, unsigned long long *out, unsigned int count);
+
 
         /**
          * H(x) = (x^(1-exponent) - 1)/(1 - exponent), if exponent!=1
@@ -206,4 +248,33 @@ class zipf_sampled {
         void zipf_sampled_initialize();
 };
 
+
+/*
+ * Buffer of Zipf variates owned by a client, refilled in batches from the
+ * (shared) sampler with the RNG of the client, so that drawing the content
+ * of a request costs an array access. A buffer of size 1 draws the same
+ * sequence of requests as zipf_sampled::sample().
+ */
+class zipf_prefetch{
+    public:
+		zipf_prefetch():sampler(NULL),rng(NULL),next(0),meta(false){;}
+		// With 'metaContents' the buffer holds meta-contents (see sample_meta()).
+		void init(zipf_sampled *z, cRNG *r, unsigned int size, bool metaContents = false);
+
+		unsigned long long pop(){
+			if (next == buffer.size())
+				refill();
+			return buffer[next++];
+		}
+
+    private:
+		void refill();
+
+		zipf_sampled *sampler;
+		cRNG *rng;
+		vector<unsigned long long> buffer;
+		size_t next;
+		bool meta;
+};
+
 #endif
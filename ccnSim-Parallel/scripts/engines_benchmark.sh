@@ -0,0 +1,68 @@
+#!/bin/bash
+
+# Benchmark of the shared steady phase of the parallel ModelGraft on
+# heterogeneous cores.
+#
+# K engines (coordinator = "socket", one per core listed in CORES) are pinned
+# to their core with taskset; the cores of the first SLOW engines are slowed
+# down by a competing busy loop pinned on them (on hybrid CPUs, list the
+# performance and the efficiency cores in CORES and use SLOW=0). Each setting
+# is run with a fixed steady phase per engine (budget_chunks = 0) and with the
+# steady phase handed out in CHUNKS chunks per engine, and the wall clock time
+# is appended to results/engines_benchmark.csv.
+#
+# Usage: [CORES="0 1 2 3"] [SLOW=1] [CHUNKS=20] ./scripts/engines_benchmark.sh [extra ccnSim options]
+# (to be launched from the ccnSim directory)
+
+extraOpts="$@"
+
+main=./ccnSim
+daemon=./tools/coordinator_daemon
+outFile=results/engines_benchmark.csv
+cores=(${CORES:-0 1 2 3})
+slow=${SLOW:-1}
+chunks=${CHUNKS:-20}
+socket=/tmp/ccnsim_bench_$$.sock
+K=${#cores[@]}
+
+if [ ! -x $daemon ]; then
+	make -C tools || exit 1
+fi
+mkdir -p results logs
+
+[ -f $outFile ] || echo "engines,slow_engines,budget_chunks,wall_clock_s" > $outFile
+
+hogs=""
+for ((e=0; e<slow && e<K; e++)); do
+	taskset -c ${cores[$e]} sh -c 'while :; do :; done' &
+	hogs="$hogs $!"
+done
+trap "kill $hogs 2>/dev/null; rm -f $socket" EXIT
+
+for budget in 0 $chunks; do
+	$daemon -socket $socket -engines $K > logs/engines_bench_daemon_${budget}.log 2>&1 &
+	daemonPid=$!
+
+	start=$(date +%s.%N)
+	pids=""
+	for ((e=0; e<K; e++)); do
+		eval taskset -c ${cores[$e]} $main -u Cmdenv -c SocketEngines -r 0 \
+			--**.num_threads=$K --**.budget_chunks=$budget --**.coordinator_socket=\"$socket\" \
+			$extraOpts Parallel_ModelGraft_Akaroa.ini > logs/engines_bench_${budget}_${e}.log 2>&1 &
+		pids="$pids $!"
+	done
+	status=0
+	for pid in $pids; do
+		wait $pid || status=1
+	done
+	end=$(date +%s.%N)
+	wait $daemonPid || status=1
+
+	if [ $status -ne 0 ]; then
+		echo "budget_chunks=$budget failed (see logs/engines_bench_${budget}_*.log)"
+	else
+		elapsed=$(echo "$end - $start" | bc -l)
+		echo "$K,$slow,$budget,$elapsed" >> $outFile
+		echo "$K engines ($slow slowed down), budget_chunks=$budget: $elapsed s"
+	fi
+done
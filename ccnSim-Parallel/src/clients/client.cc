@@ -43,6 +43,7 @@
 
 Register_Class (client);
 
+trace_writer client::recorder;
 
 void client::initialize()
 {
@@ -63,6 +64,23 @@ void client::initialize()
 	#ifdef SEVERE_DEBUG
 	interests_sent = 0;
 	#endif
+
+	oldest_download = newest_download = -1;
+
+	// The first client opens the trace of its partition (one file per partition
+	// in parallel runs), which then records the first Interest of each request.
+	string trace = par("record_trace").stdstringValue();
+	if (!trace.empty() && !recorder.is_open())
+	{
+		cEnvir *env = cSimulation::getActiveEnvir();
+		if (env->getParsimNumPartitions() > 1)
+		{
+			std::stringstream name;
+			name<<trace<<"."<<env->getParsimProcId();
+			trace = name.str();
+		}
+		recorder.open(trace.c_str());
+	}
 }
 
 int client::getNodeIndex()
@@ -72,6 +90,12 @@ int client::getNodeIndex()
 
 void client::finish()
 {
+	if (recorder.is_open())
+	{
+		cout<<"Request trace: "<<recorder.records()<<" requests recorded"<<endl;
+		recorder.close();
+	}
+
     //	Output average local statistics.
     if (active)
     {
@@ -113,33 +137,118 @@ void client::finish()
 }
 
 /*
- * 	Verifies if retransmissions are needed.
+ * 	Verifies if retransmissions are needed. Only the stalled downloads, at the
+ * 	head of the deadline list, are visited.
  */
 void client::handle_timers(cMessage *timer)
 {
-	for (multimap<name_t, download >::iterator i = current_downloads.begin();i != current_downloads.end();i++)
+	for (int i = oldest_download; i != -1 && simTime() - download_slots[i].last > RTT; i = download_slots[i].newer)
 	{
-		if ( simTime() - i->second.last > RTT )
-		{
-			#ifdef SEVERE_DEBUG
-			    chunk_t chunk = 0; 	// Allocate chunk data structure.
-									// This value wiil be overwritten soon
-				name_t object_name = i->first;
-				chunk_t object_id = __sid(chunk, object_name);
-				std::stringstream ermsg;
-				ermsg<<"Client attached to node "<< getNodeIndex() <<" was not able to retrieve object "
-					<<object_id<< " before the timeout expired. Serial number of the interest="<<
-					i->second.serial_number <<". This is not necessarily a bug. If you expect "<<
-					"such an event and you think it is not a bug, disable this error message";
-				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-			#endif
-
-		    //	Resend the request for the given chunk.
-		    cout<<getIndex()<<"]**********Client timer hitting ("<<simTime()-i->second.last<<")************"<<endl;
-		    cout<<i->first<<"(while waiting for chunk n. "<<i->second.chunk << ",of a file of "<< __size(i->first) <<" chunks at "<<simTime()<<")"<<endl;
-		    resend_interest(i->first,i->second.chunk,-1);
-	    }
+		download &d = download_slots[i];
+
+		#ifdef SEVERE_DEBUG
+		    chunk_t chunk = 0; 	// Allocate chunk data structure.
+								// This value wiil be overwritten soon
+			name_t object_name = d.name;
+			chunk_t object_id = __sid(chunk, object_name);
+			std::stringstream ermsg;
+			ermsg<<"Client attached to node "<< getNodeIndex() <<" was not able to retrieve object "
+				<<object_id<< " before the timeout expired. Serial number of the interest="<<
+				d.serial_number <<". This is not necessarily a bug. If you expect "<<
+				"such an event and you think it is not a bug, disable this error message";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		#endif
+
+	    //	Resend the request for the given chunk.
+	    cout<<getIndex()<<"]**********Client timer hitting ("<<simTime()-d.last<<")************"<<endl;
+	    cout<<d.name<<"(while waiting for chunk n. "<<d.chunk << ",of a file of "<< __size(d.name) <<" chunks at "<<simTime()<<")"<<endl;
+	    resend_interest(d.name,d.chunk,-1);
+	}
+}
+
+/*
+ * 	Start tracking a new download of file 'name'.
+ */
+void client::add_download(name_t name, const download &new_download)
+{
+	int slot;
+	if (free_slots.empty())
+	{
+		slot = download_slots.size();
+		download_slots.push_back(new_download);
+	}
+	else
+	{
+		slot = free_slots.back();
+		free_slots.pop_back();
+		download_slots[slot] = new_download;
 	}
+
+	download &d = download_slots[slot];
+	d.name = name;
+
+	// Chain it to the other downloads of the same file, if any.
+	pair< boost::unordered_map<name_t, int>::iterator, bool > ins = current_downloads.insert(make_pair(name, slot));
+	if (ins.second)
+		d.same_name = -1;
+	else
+	{
+		d.same_name = ins.first->second;
+		ins.first->second = slot;
+	}
+
+	append_download(slot);
+}
+
+void client::unlink_download(int slot)
+{
+	download &d = download_slots[slot];
+	if (d.older != -1)
+		download_slots[d.older].newer = d.newer;
+	else
+		oldest_download = d.newer;
+	if (d.newer != -1)
+		download_slots[d.newer].older = d.older;
+	else
+		newest_download = d.older;
+}
+
+void client::append_download(int slot)
+{
+	download &d = download_slots[slot];
+	d.older = newest_download;
+	d.newer = -1;
+	if (newest_download != -1)
+		download_slots[newest_download].newer = slot;
+	else
+		oldest_download = slot;
+	newest_download = slot;
+}
+
+/*
+ * 	Release the slot of a completed download.
+ */
+void client::remove_download(int slot)
+{
+	download &d = download_slots[slot];
+	unlink_download(slot);
+
+	boost::unordered_map<name_t, int>::iterator it = current_downloads.find(d.name);
+	if (it->second == slot)
+	{
+		if (d.same_name == -1)
+			current_downloads.erase(it);
+		else
+			it->second = d.same_name;
+	}
+	else
+	{
+		int prev = it->second;
+		while (download_slots[prev].same_name != slot)
+			prev = download_slots[prev].same_name;
+		download_slots[prev].same_name = d.same_name;
+	}
+	free_slots.push_back(slot);
 }
 
 
@@ -183,6 +292,9 @@ void client::send_interest(name_t name,cnumber_t number, int toward)
 	interests_sent++;
 	#endif
 
+	if (number == 0 && recorder.is_open())		// A new request.
+		recorder.append(SIMTIME_DBL(simTime()), getNodeIndex(), name);
+
     send(interest, "client_port$o");
 }
 
@@ -230,41 +342,33 @@ void client::handle_incoming_chunk (ccn_data *data_message)
 
 
     //-----------Handling downloads------
-    pair< multimap<name_t, download>::iterator, multimap<name_t, download>::iterator > ii;
-    multimap<name_t, download>::iterator it;
+    boost::unordered_map<name_t, int>::iterator it = current_downloads.find(name);
+    int slot = (it != current_downloads.end()) ? it->second : -1;
 
-    ii = current_downloads.equal_range(name);
-    it = ii.first;
-
-    while (it != ii.second)
+    while (slot != -1)
 	{
-        if ( it->second.chunk == chunk_num )
+        download &d = download_slots[slot];
+        int next = d.same_name;
+        if ( d.chunk == chunk_num )
 		{
-            it->second.chunk++;
-            if (it->second.chunk< __size(name) )
+            d.chunk++;
+            if (d.chunk< __size(name) )
 			{
-		    	it->second.last = simTime();
+		    	d.last = simTime();
+		    	unlink_download(slot);		// Its deadline is now the latest one.
+		    	append_download(slot);
 		    	// If the file is not completed yet, send the next Interest.
-		    	send_interest(name, it->second.chunk, data_message->getTarget());
+		    	send_interest(name, d.chunk, data_message->getTarget());
             }
             else
             {
 	        	// Delete the entry related to the completed file from the list.
-				simtime_t completion_time = simTime()-it->second.start;
+				simtime_t completion_time = simTime()-d.start;
 				avg_time = (tot_chunks * avg_time + completion_time ) * 1./( tot_chunks+1 );
-		    	if (current_downloads.count(name)==1)
-				{
-		    	    current_downloads.erase(name);
-		    	    break;
-		    	}
-		    	else
-		    	{
-		    	    current_downloads.erase(it++);
-		    	    continue;
-		    	}
+				remove_download(slot);
 			}
         }
-        ++it;
+        slot = next;
     }
     tot_chunks++;
 }
@@ -311,6 +415,10 @@ double client::get_tot_downloads()
 {
 	return tot_downloads;
 }
+unsigned int client::get_tot_chunks()
+{
+	return tot_chunks;
+}
 simtime_t client::get_avg_time()
 {
 	return avg_time;
@@ -327,8 +435,7 @@ unsigned int client::get_interests_sent(){
 
 bool client::is_waiting_for(name_t name)
 {
-	multimap<name_t, download>::iterator it = current_downloads.find(name);
-	return it != current_downloads.end();
+	return current_downloads.find(name) != current_downloads.end();
 }
 #endif
 
@@ -43,6 +43,8 @@
 
 Register_Class (client_IRM);
 
+vector<client_IRM*> client_IRM::superposed_clients;
+vector<double> client_IRM::superposed_cdf;
 
 void client_IRM::initialize()
 {
@@ -78,16 +80,31 @@ void client_IRM::initialize()
 
 			alphaVal = content_distribution::zipf[0]->get_alpha();
 
-			if(down > 1)		// ModelGraft
+			// Contents to be requested are drawn in batches of 'zipf_batch'. With ModelGraft
+			// they are directly drawn among the meta-contents of the downscaled catalog.
+			zipf_requests.init(content_distribution::zipf[0], stream(), par("zipf_batch"), down > 1);
+
+			request_rate = down > 1 ? lambda/down : lambda;
+			superposed = par("superposed_arrivals");
+			if(superposed && down >= 1)
+			{
+				superposed_clients.push_back(this);
+				if(superposed_clients.size() == 1)		// Leader: its first event only sets up the aggregate process.
+				{
+					arrival_superposed = new cMessage("arrival_superposed", ARRIVAL_SUPERPOSED);
+					scheduleAt( simTime(), arrival_superposed);
+				}
+			}
+			else if(down > 1)		// ModelGraft
 			{
 				// Schedule a ModelGraft request (i.e., arrival_ttl) at lambda/down rate
 				arrival_ttl = new cMessage("arrival_ttl", ARRIVAL_TTL);
-				scheduleAt( simTime() + uniform(0,(double)(1./(double)(lambda/down))), arrival_ttl);
+				scheduleAt( simTime() + stream()->doubleRand()*(1./(lambda/down)), arrival_ttl);
 			}
 			else if(down == 1)		// ED-sim scenario
 			{
 				arrival = new cMessage("arrival", ARRIVAL );
-				scheduleAt( simTime() + uniform(0,1./lambda), arrival);
+				scheduleAt( simTime() + stream()->doubleRand()*(1./lambda), arrival);
 			}
 			else
 			{
@@ -102,41 +119,28 @@ void client_IRM::initialize()
 
 void client_IRM::finish()
 {
+	superposed_clients.clear();
+	superposed_cdf.clear();
 	client::finish();
 }
 
 void client_IRM::handleMessage(cMessage *in)
 {
-	unsigned long long origContent;
-	unsigned long metaContent;
-
     if (in->isSelfMessage())	// A self-generated message can be either an 'ARRIVAL', an 'ARRIVAL_TTL', or a 'TIMER'.
     {
 		switch(in->getKind())
 		{
 		case ARRIVAL:
-			request_file(newCard+1);   // 'newCard+1' is needed to discern between ED-sim and ModelGraft.
-			scheduleAt( simTime() + exponential(1./lambda), arrival );
+			generate_request();
+			scheduleAt( simTime() + rng_exponential(stream(), 1./lambda), arrival );
 			break;
 		case ARRIVAL_TTL:
-			// Extract a content from the original catalog (i.e., M cardinality) through the inversion rejection sampling
-			origContent = content_distribution::zipf[0]->sample();
-
-			// Compute the correspondent meta-content to be requested (i.e., newCard cardinality)
-			metaContent = floor(origContent/down) + 1;
-
-		    if(metaContent > 0 && metaContent <= newCard)
-		    {
-		    	request_file(metaContent);
-		    	scheduleAt( simTime() + exponential(1./(lambda/down)), arrival_ttl);  // Schedule the next request
-		    }
-		    else
-		    {
-		    	std::stringstream ermsg;
-		    	ermsg<<"ERROR - Client IRM: received wrong self message identifier. Please check";
-		    	severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-		    }
+			generate_request();
+			scheduleAt( simTime() + rng_exponential(stream(), 1./(lambda/down)), arrival_ttl);  // Schedule the next request
 		    break;
+		case ARRIVAL_SUPERPOSED:
+			handle_superposed_arrival();
+			break;
 		case TIMER:
 			handle_timers(in);
 			scheduleAt( simTime() + check_time, timer );
@@ -181,6 +185,95 @@ void client_IRM::handleMessage(cMessage *in)
 }
 
 
+/*
+ *		The first arrival was drawn in initialize(), with the streams of the process
+ *		that forked the engines: draw it again from the streams of this engine.
+ */
+void client_IRM::restart_arrivals()
+{
+	Enter_Method_Silent();
+
+	if(!active || onlyModel)
+		return;
+
+	if(superposed && down >= 1)
+	{
+		// Only the leader holds the aggregate process, which has no arrival to
+		// redraw before its first event.
+		if(superposed_clients[0] == this && !superposed_cdf.empty() && arrival_superposed->isScheduled())
+		{
+			cancelEvent(arrival_superposed);
+			scheduleAt( simTime() + rng_exponential(stream(), 1./superposed_cdf.back()), arrival_superposed);
+		}
+	}
+	else if(down > 1)		// ModelGraft
+	{
+		cancelEvent(arrival_ttl);
+		scheduleAt( simTime() + stream()->doubleRand()*(1./(lambda/down)), arrival_ttl);
+	}
+	else					// ED-sim
+	{
+		cancelEvent(arrival);
+		scheduleAt( simTime() + stream()->doubleRand()*(1./lambda), arrival);
+	}
+}
+
+/*
+ *		Issue the next request of the client. It is called either by the client itself
+ *		or, with superposed arrivals, by the leader of the partition.
+ */
+void client_IRM::generate_request()
+{
+	Enter_Method_Silent();
+
+	if(down == 1)		// ED-sim
+	{
+		request_file(newCard+1);   // 'newCard+1' is needed to discern between ED-sim and ModelGraft.
+		return;
+	}
+
+	// Extract the meta-content to be requested (i.e., newCard cardinality), distributed as
+	// floor(origContent/down)+1 with origContent drawn from the original catalog (i.e., M cardinality)
+	unsigned long metaContent = zipf_requests.pop();
+
+	if(metaContent > 0 && metaContent <= newCard)
+		request_file(metaContent);
+	else
+	{
+		std::stringstream ermsg;
+		ermsg<<"ERROR - Client IRM: meta-content "<<metaContent<<" out of range. Please check";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+}
+
+/*
+ *		Event of the aggregate arrival process (leader only). The superposition of the
+ *		Poisson processes of the clients is a Poisson process with the sum of their rates,
+ *		in which each arrival belongs to a client with probability proportional to its rate:
+ *		one event per request instead of one event (and one FES entry) per client.
+ */
+void client_IRM::handle_superposed_arrival()
+{
+	// The first event (at time 0) comes after the initialization of all the clients:
+	// it collects their rates and schedules the first arrival.
+	if(superposed_cdf.size() != superposed_clients.size())
+	{
+		superposed_cdf.resize(superposed_clients.size());
+		double total = 0;
+		for(unsigned i = 0; i < superposed_clients.size(); i++)
+			superposed_cdf[i] = (total += superposed_clients[i]->request_rate);
+	}
+	else
+	{
+		double u = stream()->doubleRand() * superposed_cdf.back();
+		unsigned i = upper_bound(superposed_cdf.begin(), superposed_cdf.end(), u) - superposed_cdf.begin();
+		if(i == superposed_cdf.size())
+			i--;
+		superposed_clients[i]->generate_request();
+	}
+	scheduleAt( simTime() + rng_exponential(stream(), 1./superposed_cdf.back()), arrival_superposed);
+}
+
 /*
  *		Generate Interest packets according to an IRM process. Inter-request times are exponentially distributed
  *		with mean = down/lambda.
@@ -193,7 +286,7 @@ void client_IRM::request_file(unsigned long nameC)
 	name_t name;
 
 	if(nameC == newCard+1)  // ED-sim
-		name = content_distribution::zipf[0]->sample();	// Extract a content from the original catalog (rejection-inversion sampling)
+		name = zipf_requests.pop();	// Extract a content from the original catalog (rejection-inversion sampling)
 	else					// ModelGraft (TTL-based)
 		name = (name_t) nameC;
 
@@ -215,7 +308,7 @@ void client_IRM::request_file(unsigned long nameC)
 	}
 	#endif
 
-	current_downloads.insert(pair<name_t, download >(name, new_download ) );
+	add_download(name, new_download);
 	//cout << " ** Interest Sent for:\t" << name << endl;
 	send_interest(name, 0 ,-1);
 }
@@ -69,18 +69,21 @@ void client_ShotNoise::initialize(int stage)
 					validatedReq.resize(snPointer->numOfClasses, 0);
 
 					// Take info and initialize the respective structures.
+					lambdaTotal = 0;
 					for (int i=0; i<snPointer->numOfClasses; i++)
 					{
-						// The identifier of each msg will correspond to the class number.
-						cMessage* tempArrival = new cMessage("tempArrival", (short)(i+1));
-						arrivals.push_back(tempArrival);
-						scheduleAt( simTime() + exponential(1./snPointer->classInfo->operator [](i).lambdaClient), arrivals[i]);
+						lambdaTotal += snPointer->classInfo->operator [](i).lambdaClient;
 
 						// Check if the class will be modeled as ON-OFF.
-						if (snPointer->classInfo->operator [](i).ton > snPointer->steadySimTime)
+						if (!snPointer->on_off_class(i+1))
 							onOffClass[i] = false;	// The ON period of the class is longer the the whole simulation.
 					}
 
+					// The request processes of the classes are superposed in a single one, whose
+					// arrivals belong to class 'i' with probability percReq_i = lambdaClient_i / lambdaTotal.
+					arrival = new cMessage("arrival", ARRIVAL);
+					scheduleAt( simTime() + rng_exponential(stream(), 1./lambdaTotal), arrival);
+
 					active = true;
 					lambda = getAncestorPar("lambda");		// Unused (the lambda is calculated for each class according to the configuration file).
 					check_time	= getAncestorPar("check_time");
@@ -111,6 +114,20 @@ void client_ShotNoise::finish()
 	client::finish();
 }
 
+/*
+ *		The first arrival was drawn in initialize(), with the streams of the process
+ *		that forked the engines: draw it again from the streams of this engine.
+ */
+void client_ShotNoise::restart_arrivals()
+{
+	Enter_Method_Silent();
+
+	if(!active)
+		return;
+	cancelEvent(arrival);
+	scheduleAt( simTime() + rng_exponential(stream(), 1./lambdaTotal), arrival);
+}
+
 
 void client_ShotNoise::handleMessage(cMessage *in)
 {
@@ -124,31 +141,26 @@ void client_ShotNoise::handleMessage(cMessage *in)
 			scheduleAt( simTime() + check_time, timer );
 			return;
     	}
-    	else       // It can be a request for class 'msgID'.
+    	else if(msgID == ARRIVAL)
     	{
-    		bool check = false;
-    		for(short i=0; i<snPointer->numOfClasses; i++)
-    		{
-    			if( (i+1) == msgID)
-    			{
-    				request_file(i+1);  	// Request contents from the 'msgID'-th popularity class.
-
-    				// Re-schedule a request according to the lambda of the 'msgID' class.
-    				scheduleAt( simTime() + exponential(1./snPointer->classInfo->operator [](i).lambdaClient), arrivals[i]);
-    				check = true;
-    				scheduledReq[i]++;
-    			}
-    		}
-
-    		if(!check)  	// msgID does not correspond to any of the class identifiers.
-    		{
-    			std::stringstream ermsg;
-    			ermsg<<"ERROR - The message identifier does not correspond to any of the class identifier"<<
-    					" type. Please check.";
-    			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-    		}
+    		// Draw the class of the request.
+    		vector<double> &cdf = snPointer->classCdf;
+    		int i = upper_bound(cdf.begin(), cdf.end(), stream()->doubleRand() * cdf.back()) - cdf.begin();
+    		if (i == snPointer->numOfClasses)
+    			i--;
+
+    		request_file(i+1);  	// Request contents from the 'i+1'-th popularity class.
+    		scheduledReq[i]++;
+
+    		scheduleAt( simTime() + rng_exponential(stream(), 1./lambdaTotal), arrival);
     		return;
     	}
+    	else
+    	{
+    		std::stringstream ermsg;
+    		ermsg<<"ERROR - Client ShotNoise: received wrong self message identifier. Please check";
+    		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+    	}
     }
 
     switch (in->getKind())	// In case of an external message, it can only be a DATA packet.
@@ -192,7 +204,7 @@ void client_ShotNoise::handleMessage(cMessage *in)
 void client_ShotNoise::request_file(int cNum)
 {
 	// Extract a 'local' content ID from the range associated to class 'cNum'.
-	name_t nameLocal = snPointer->zipfClasses.operator [](cNum-1)->value(dblrand());
+	name_t nameLocal = snPointer->zipfClasses.operator [](cNum-1)->value(stream()->doubleRand());
 
 	// Obtaining the 'global' content ID by adding the lower bound ID of class 'cNum'.
 	name_t nameGlobal = snPointer->classInfo->operator [](cNum-1).mostPopular - 1  + nameLocal;
@@ -215,7 +227,7 @@ void client_ShotNoise::request_file(int cNum)
 			}
 			#endif
 
-			current_downloads.insert(pair<name_t, download >(nameGlobal, new_download ) );
+			add_download(nameGlobal, new_download);
 			send_interest(nameGlobal, 0 ,-1);
 		}
 		else
@@ -239,14 +251,14 @@ void client_ShotNoise::request_file(int cNum)
 		}
 		#endif
 
-		current_downloads.insert(pair<name_t, download >(nameGlobal, new_download ) );
+		add_download(nameGlobal, new_download);
 		send_interest(nameGlobal, 0 ,-1);
 	}
 }
 
 /*
- * 		Validate the request for the extracted content. Both the 'State' (i.e., ON/OFF) and the
- * 		'Transition Time' of the specified content are checked end eventually updated.
+ * 		Validate the request for the extracted content, i.e., check that it is within
+ * 		one of its ON windows (see ShotNoiseContentDistribution::is_on()).
  *
  * 		Parameters:
  * 		- cNum: class number;
@@ -254,60 +266,5 @@ void client_ShotNoise::request_file(int cNum)
  */
 bool client_ShotNoise::validateRequest(int cNum, name_t ID)
 {
-	bool sendOk = true;
-	simtime_t contentTime = snPointer->get_state_time(ID-1);
-
-	if (snPointer->check_state_flag(ID-1))  	// The content was ON.
-	{
-		if (simTime() <= contentTime)  			// The content is still ON.
-		{
-			// Do nothing. The content was ON and it is still ON; as a consequence, 'sendOK' remains true.
-		}
-		else	// Sim_time > ON_time associated to the content, which, as a consequence,
-			    // can be either ON or OFF at the current moment. Therefore, we need to update
-				// the ON/OFF process (state and transition time) associated to the content.
-		{
-			while (contentTime < simTime())
-			{
-				// We add first the OFF time because the content was in a ON state.
-				contentTime += snPointer->classInfo->operator [](cNum-1).toff;
-				snPointer->unset_state_flag(ID-1);
-				sendOk = false;
-				if (contentTime < simTime())	// We need to extract another ON time.
-				{
-					contentTime += (simtime_t)exponential(snPointer->classInfo->operator [](cNum-1).ton);
-					snPointer->set_state_flag(ID-1);
-					sendOk = true;
-				}
-			}
-			snPointer->set_state_time(ID-1, contentTime);		// Update the transition time of the content.
-		}
-	}
-	else		// The content was OFF.
-	{
-		if (simTime() <= contentTime)	// The content is still OFF.
-		{
-			sendOk = false;		// Do not generate the request.
-		}
-		else	// Sim_time > OFF_time associated to the content, which, as a consequence,
-		    	// can be either ON or OFF at the current moment. Therefore, we need to update
-				// the ON/OFF process (state and transition time) associated to the content.
-		{
-			while (contentTime < simTime())
-			{
-				// We add first the ON time because the content was in a OFF state.
-				contentTime += (simtime_t)exponential(snPointer->classInfo->operator [](cNum-1).ton);
-				snPointer->set_state_flag(ID-1);
-				sendOk = true;
-				if(contentTime < simTime())		// We need to extract another OFF time.
-				{
-					contentTime += snPointer->classInfo->operator [](cNum-1).toff;
-					snPointer->unset_state_flag(ID-1);
-					sendOk = false;
-				}
-			}
-			snPointer->set_state_time(ID-1, contentTime);			// Update the transition time of the content.
-		}
-	}
-	return sendOk;
+	return snPointer->is_on(cNum, ID, simTime());
 }
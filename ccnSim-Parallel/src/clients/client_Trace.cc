@@ -0,0 +1,197 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "content_distribution.h"
+
+#include "ccn_interest.h"
+#include "ccn_data.h"
+
+#include "ccnsim.h"
+#include "client_Trace.h"
+
+#include "error_handling.h"
+
+Register_Class (client_Trace);
+
+trace_reader client_Trace::reader;
+trace_record client_Trace::next_request;
+bool client_Trace::pending = false;
+vector<client_Trace*> client_Trace::node_clients;
+unsigned long long client_Trace::replayed = 0;
+unsigned long long client_Trace::skipped = 0;
+unsigned long long client_Trace::catalog_card = 0;
+
+
+void client_Trace::initialize()
+{
+	int num_clients = getAncestorPar("num_clients");
+	active = false;
+	arrival = NULL;
+	if (find(content_distribution::clients, content_distribution::clients + num_clients ,getNodeIndex()) != content_distribution::clients + num_clients)
+	{
+		active = true;
+		lambda = getAncestorPar("lambda");
+		check_time	= getAncestorPar("check_time");
+
+		timer = new cMessage("timer", TIMER);
+		scheduleAt( simTime() + check_time, timer );
+
+		// The first active client of the partition is the reader of the trace.
+		bool first = node_clients.empty();
+		if (first)
+			node_clients.assign((int)getAncestorPar("n"), (client_Trace*)NULL);
+		node_clients[getNodeIndex()] = this;
+
+		if (first)
+		{
+			content_distribution *cd = dynamic_cast<content_distribution *>(getParentModule()->getParentModule()->getSubmodule("content_distribution"));
+			if (!cd)
+			{
+				std::stringstream ermsg;
+				ermsg<<"client_Trace needs the content_distribution module to validate the trace";
+				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+			}
+			catalog_card = cd->get_catalog_card();
+			reader.open(par("trace_file").stringValue());
+			replayed = skipped = 0;
+			pending = reader.next(next_request);
+			if (pending)
+			{
+				arrival = new cMessage("arrival", ARRIVAL );
+				scheduleAt( simtime_t(next_request.time), arrival);
+			}
+		}
+		client::initialize();
+	}
+}
+
+void client_Trace::finish()
+{
+	// The first client to finish closes the trace of the partition.
+	if (!node_clients.empty())
+	{
+		recordScalar("trace_replayed", replayed);
+		recordScalar("trace_skipped", skipped);
+		cout<<"Request trace: "<<replayed<<" requests replayed, "<<skipped<<" skipped"<<endl;
+		reader.close();
+		node_clients.clear();
+		pending = false;
+	}
+	client::finish();
+}
+
+void client_Trace::handleMessage(cMessage *in)
+{
+    if (in->isSelfMessage())	// A self-generated message can be either an 'ARRIVAL' or a 'TIMER'.
+    {
+		switch(in->getKind())
+		{
+		case ARRIVAL:
+			replay();
+			break;
+		case TIMER:
+			handle_timers(in);
+			scheduleAt( simTime() + check_time, timer );
+			break;
+		default:
+			std::stringstream ermsg_a;
+			ermsg_a<<"ERROR - Client Trace: received wrong self message identifier. Please check";
+			severe_error(__FILE__,__LINE__,ermsg_a.str().c_str() );
+			break;
+		}
+		return;
+    }
+
+    switch (in->getKind())		// In case of an external message, it can only be a DATA packet.
+ 	{
+ 		case CCN_D:
+ 		{
+ 			ccn_data *data_message = (ccn_data *) in;
+ 			handle_incoming_chunk (data_message);
+ 			delete  data_message;
+ 			break;
+ 		}
+
+ 		#ifdef SEVERE_DEBUG
+ 		default:
+ 			std::stringstream ermsg;
+ 			ermsg<<"Clients can only receive DATA, while this is a message"<<
+ 				" of TYPE "<<in->getKind();
+ 			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+ 		#endif
+    }
+}
+
+/*
+ *		Issue all the requests of the trace due now (reader only), then wait for the
+ *		next one. Times are compared as simtime_t, the same rounding used by scheduleAt().
+ */
+void client_Trace::replay()
+{
+	while (pending && simtime_t(next_request.time) <= simTime())
+	{
+		client_Trace *c = NULL;
+		if (next_request.client >= 0 && next_request.client < (int)node_clients.size())
+			c = node_clients[next_request.client];
+		if (c)
+		{
+			c->request_file(next_request.content);
+			replayed++;
+		}
+		else
+			skipped++;
+		pending = reader.next(next_request);
+	}
+	if (pending)
+		scheduleAt( simtime_t(next_request.time), arrival);
+}
+
+void client_Trace::request_file(unsigned long nameC)
+{
+	Enter_Method_Silent();
+
+	// Contents are numbered from 1 to cardF, and the name has to fit in the
+	// ID field of the chunk.
+	if (nameC < 1 || nameC > catalog_card || (unsigned long long)nameC > (ID_MSK >> ID_OFFSET))
+	{
+		std::stringstream ermsg;
+		ermsg<<"The request trace contains the content "<<nameC<<", while contents are numbered from 1 to "<<catalog_card;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	name_t name = (name_t) nameC;
+
+	struct download new_download = download (0,simTime() );
+	#ifdef SEVERE_DEBUG
+	new_download.serial_number = interests_sent;
+	#endif
+
+	add_download(name, new_download);
+	send_interest(name, 0 ,-1);
+}
@@ -66,6 +66,9 @@ void client_Window::initialize()
 		maxWinSize = par("maxWinSize");
 		currWinSize = defWinSize;
 
+		// Contents to be requested are drawn in batches of 'zipf_batch'.
+		zipf_requests.init(content_distribution::zipf[0], stream(), par("zipf_batch"));
+
 		// Being an open-loop flow control, we set a deterministic timer in order to reset the size of the window,
 		// depending on the maximum size achievable for the window itself.
 		winTout = 0.0;
@@ -199,7 +202,7 @@ void client_Window::request_file_window(unsigned long cNum)
 			//name = content_distribution::zipf[0].value(dblrand());
 			//name = content_distribution::zipf[0].sample();  // With Rejection-inversion sampling
 			// ** ACCURACY BOOST - START**
-			name = content_distribution::zipf[0]->sample();  // With Rejection-inversion sampling
+			name = zipf_requests.pop();  // With Rejection-inversion sampling
 			// ** ACCURACY BOOST - END**
 			if(find(reqContents.begin(), reqContents.end(), name) == reqContents.end())
 				found = false;
@@ -226,7 +229,7 @@ void client_Window::request_file_window(unsigned long cNum)
 
 
 		struct download new_download = download (0,simTime() );
-		current_downloads.insert(pair<name_t, download >(name, new_download ) );
+		add_download(name, new_download);
 		send_interest(name, 0 ,-1);
 	}
 	// Set the number of in-flights packets
@@ -244,7 +247,7 @@ void client_Window::request_file_window(unsigned long cNum)
 void client_Window::request_file(unsigned long cNum)
 {
 	//name_t name = content_distribution::zipf[0].value(dblrand());
-	name_t name = content_distribution::zipf[0]->sample();  // With Rejection-inversion sampling
+	name_t name = zipf_requests.pop();  // With Rejection-inversion sampling
 
 	/*// ****  NB - COMMENT with Rejection-Inversion sampling
 	// Check if the catalog aggregation is active. In this case, request for less popular contents
@@ -279,6 +282,6 @@ void client_Window::request_file(unsigned long cNum)
 	}
 	#endif
 
-	current_downloads.insert(pair<name_t, download >(name, new_download ) );
+	add_download(name, new_download);
 	send_interest(name, 0 ,-1);
 }
@@ -0,0 +1,185 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "request_trace.h"
+#include "error_handling.h"
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Records buffered by trace_writer before a write.
+#define TRACE_BUFFER (1UL << 20)
+
+void trace_writer::open(const char *path)
+{
+	close();
+	file = fopen(path, "wb");
+	if (!file){
+		std::stringstream ermsg;
+		ermsg<<"Impossible to create the request trace "<<path;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	buffer.reserve(TRACE_BUFFER + 32);
+	buffer.assign(TRACE_MAGIC, TRACE_MAGIC + TRACE_MAGIC_LEN);
+	last_ns = 0;
+	count = 0;
+}
+
+void trace_writer::put(unsigned long long v)
+{
+	while (v >= 0x80){
+		buffer.push_back((unsigned char)(v | 0x80));
+		v >>= 7;
+	}
+	buffer.push_back((unsigned char)v);
+}
+
+void trace_writer::append(double time, int client, unsigned long long content)
+{
+	unsigned long long ns = llround(time * 1e9);
+	if (ns < last_ns){
+		std::stringstream ermsg;
+		ermsg<<"Request trace: the request at time "<<time<<" precedes the previous one";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	put(ns - last_ns);
+	put(client);
+	put(content);
+	last_ns = ns;
+	count++;
+	if (buffer.size() >= TRACE_BUFFER)
+		flush();
+}
+
+void trace_writer::flush()
+{
+	if (!buffer.empty() && fwrite(&buffer[0], 1, buffer.size(), file) != buffer.size())
+		severe_error(__FILE__,__LINE__,"Impossible to write the request trace");
+	buffer.clear();
+}
+
+void trace_writer::close()
+{
+	if (!file)
+		return;
+	flush();
+	fclose(file);
+	file = NULL;
+}
+
+void trace_reader::open(const char *path)
+{
+	close();
+	int fd = ::open(path, O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0){
+		std::stringstream ermsg;
+		ermsg<<"Impossible to open the request trace "<<path;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	size = st.st_size;
+	if (size < TRACE_MAGIC_LEN ||
+		(data = (const unsigned char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED){
+		data = NULL;
+		::close(fd);
+		std::stringstream ermsg;
+		ermsg<<"Impossible to map the request trace "<<path;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	::close(fd);		// The mapping stays valid.
+
+	if (memcmp(data, TRACE_MAGIC, TRACE_MAGIC_LEN) != 0){
+		std::stringstream ermsg;
+		ermsg<<path<<" is not a request trace";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	madvise((void *)data, size, MADV_SEQUENTIAL);
+	pos = TRACE_MAGIC_LEN;
+	last_ns = 0;
+	advised = 0;
+	read_ahead();
+}
+
+void trace_reader::read_ahead()
+{
+	// Called when pos enters the window ending at 'advised'.
+	size_t page = sysconf(_SC_PAGESIZE);
+	size_t start = advised;
+	advised = min(size, start + TRACE_WINDOW);
+	if (advised > start){
+		size_t aligned = start / page * page;
+		madvise((void *)(data + aligned), advised - aligned, MADV_WILLNEED);
+	}
+	if (start >= 2*TRACE_WINDOW){
+		size_t end = (start - TRACE_WINDOW) / page * page;
+		madvise((void *)data, end, MADV_DONTNEED);
+	}
+}
+
+bool trace_reader::get(unsigned long long &v)
+{
+	v = 0;
+	for (int shift = 0; pos < size && shift < 64; shift += 7){
+		unsigned char b = data[pos++];
+		v |= (unsigned long long)(b & 0x7f) << shift;
+		if (!(b & 0x80))
+			return true;
+	}
+	return false;
+}
+
+bool trace_reader::next(trace_record &r)
+{
+	if (!data || pos >= size)
+		return false;
+	if (pos + 3*10 > advised && advised < size)
+		read_ahead();
+
+	unsigned long long dt = 0, client = 0, content = 0;
+	if (!get(dt) || !get(client) || !get(content))
+		severe_error(__FILE__,__LINE__,"Truncated request trace");
+	last_ns += dt;
+	r.time = last_ns * 1e-9;
+	r.client = (int)client;
+	r.content = content;
+	return true;
+}
+
+void trace_reader::close()
+{
+	if (data)
+		munmap((void *)data, size);
+	data = NULL;
+	size = pos = advised = 0;
+}
@@ -38,13 +38,19 @@ Register_Class(ShotNoiseContentDistribution);
 
 vector<zipf_distribution*> ShotNoiseContentDistribution::zipfClasses;
 
+// Contents per page of ON windows.
+#define ON_OFF_PAGE 4096
+// Requested contents after which a page is stored as an array. A window takes
+// 12 bytes in the array and about 48 in sparse_windows (node, allocator
+// overhead and bucket), so beyond ON_OFF_PAGE/4 requested contents the array
+// is smaller.
+#define ON_OFF_DENSE (ON_OFF_PAGE/4)
+
 void ShotNoiseContentDistribution::initialize()
 {
 	cout << "Initialize SHOT NOISE content distribution...\tTime:\t" << SimTime() << "\n";
 
 	classInfo = new vector<classInfoEntry> ();
-	state_flags = new boost::dynamic_bitset<> ();
-	state_times = new vector<simtime_t>	();
 
 	const char *fileName = par("shot_noise_file").stringValue();	// Read the configuration file name.
 	tOffMultFactor = par("toff_mult_factor");						// Read the Toff multiplicative factor.
@@ -54,7 +60,7 @@ void ShotNoiseContentDistribution::initialize()
 	// Read configuration file.
 	import_catalog_features(fileName);
 
-	// Initialize both State Flags and Transition Times for each content.
+	// Initialize the ON/OFF process of the contents and the popularity of the classes.
 	initialize_contents();
 
 	content_distribution::initialize();
@@ -66,9 +72,15 @@ void ShotNoiseContentDistribution::initialize()
 
 void ShotNoiseContentDistribution::finish()
 {
+	recordScalar("on_off_pages", allocated_pages);
+	recordScalar("on_off_sparse", sparse_windows.size());
+	for (uint32_t i=0; i<on_off_pages.size(); i++)
+		for (uint32_t j=0; j<on_off_pages[i].size(); j++)
+			delete [] on_off_pages[i][j].dense;
+	on_off_pages.clear();
+	sparse_windows.clear();
+
 	delete classInfo;
-	delete state_flags;
-	delete state_times;
 	for (uint32_t i=0; i<zipfClasses.size(); i++)
 		delete zipfClasses[i];
 }
@@ -168,6 +180,7 @@ void ShotNoiseContentDistribution::import_catalog_features(const char* path)
 	    	cout << "Lambda = " << classInfo->operator [](i).lambdaClass << "\n";
 	    	// Calculate the percentage of requests related to class 'i'.
 	    	classInfo->operator [](i).percReq = (double)(classInfo->operator [](i).lambdaClass / totalLambda);
+	    	classCdf.push_back((i > 0 ? classCdf.back() : 0) + classInfo->operator [](i).percReq);
 	    	cout << "Percentage of Requests = " << classInfo->operator [](i).percReq << "\n";
 	    	cout << "Most popular content ID:\t" << classInfo->operator[](i).mostPopular << "\n";
 	    	cout << "Less popular content ID:\t" << classInfo->operator[](i).lessPopular << "\n";
@@ -185,45 +198,28 @@ void ShotNoiseContentDistribution::import_catalog_features(const char* path)
 }
 
 /*
- *  Initialize State flags and the initial Transition Times for each content.
+ *  Initialize the ON/OFF process of the contents. Nothing is stored per content
+ *  until it is requested (see is_on()).
  */
 void ShotNoiseContentDistribution::initialize_contents()
 {
-	// If Ton_i > steadySimTime for class 'i', the respective contents will be always ON.
-	// Therefore, they will be not modeled as part of the ON-OFF process (i.e., state_flags
-	// and state_times will not be initialized).
-
-	// Calculate the number of contents worth to be simulated as ON-OFF.
-	long double onOffContents = 0;
-	for (uint32_t i=0; i<classInfo->size(); i++)
+	cRNG *rng = philox_rng::module_stream(this);
+	on_off_seed = ((uint64_t)rng->intRand() << 32) ^ rng->intRand();
+	on_off_pages.assign(numOfClasses, vector<on_off_page>());
+	allocated_pages = 0;
+	on_off_page empty = {NULL, 0};
+	for (int i=0; i<numOfClasses; i++)
 	{
-		if (classInfo->operator [](i).ton < steadySimTime)
-			onOffContents += classInfo->operator [](i).numContents;
-		else
-			break;
-	}
-
-	// Initialize the vector containing the State flags (initially all the contents are ON).
-	state_flags->resize(onOffContents, true);
-
-	// Initializing the vector containing the Transition Times.
-	state_times->resize(onOffContents);
-
-	int i=0;
-	for(uint32_t j=1; j<=onOffContents; j++)
-	{
-		state_times->operator[](j-1) = (simtime_t)exponential(classInfo->operator [](i).ton);
-		if(j==classInfo->operator [](i).lessPopular)
-		{
-			cout << "Class:\t" << i+1 << "\tContent:\t" << j << "\tTransition Time:\t" << state_times->operator[](j-1) << "\n";
-			++i;  	// Use the parameters of the subsequent content class.
-		}
+		// If Ton_i >= steadySimTime for class 'i', the respective contents will be always ON.
+		if (on_off_class(i+1))
+			on_off_pages[i].resize(((unsigned long)classInfo->operator [](i).numContents + ON_OFF_PAGE - 1) / ON_OFF_PAGE, empty);
 	}
 
 	// Initialize the structure containing the Zipf distributions for all the classes.
 	for(int k=0; k<numOfClasses; k++)
 	{
 		zipf_distribution* tempZipf = new zipf_distribution(classInfo->operator [](k).classAlpha, 0, classInfo->operator [](k).numContents, 1, k+1);
+		tempZipf->set_compact_cdf(par("compact_cdf").boolValue());
 		tempZipf->zipf_initialize();
 		zipfClasses.push_back(tempZipf);
 		//cout << "90th percentile of class " << k+1 << ":\t" << zipfClasses[k]->value(0.9) << endl;
@@ -231,81 +227,87 @@ void ShotNoiseContentDistribution::initialize_contents()
 }
 
 /*
- * 	Set the state of the specified content as "ON".
- *
- * 	Parameters:
- * 	- contentID: ID of the specified content.
+ * 	True if the contents of class 'cNum' follow an ON/OFF process (i.e., their
+ * 	mean ON time is shorter than the simulation); otherwise they are always ON.
  */
-void ShotNoiseContentDistribution::set_state_flag(int contentID)
+bool ShotNoiseContentDistribution::on_off_class(int cNum)
 {
-	if ((uint32_t)contentID < state_flags->size())
-		state_flags->operator[](contentID) = 1;
-	else
-		cout << "Trying to set the state flag of a non existent content!\n";
+	return classInfo->operator [](cNum-1).ton < steadySimTime;
 }
 
 /*
- * 	Set the state of the specified content as "OFF".
- *
- * 	Parameters:
- * 	- contentID: ID of the specified content.
+ * 	Duration of the k-th ON window of the content 'ID' (global ID) of class 'cNum'.
  */
-void ShotNoiseContentDistribution::unset_state_flag(int contentID)
+double ShotNoiseContentDistribution::on_duration(int cNum, name_t ID, uint32_t k)
 {
-	if ((uint32_t)contentID < state_flags->size())
-		state_flags->operator[](contentID) = 0;
-	else
-		cout << "Trying to unset the state flag of a non existent content!\n";
+	content_stream stream(on_off_seed, ID);
+	return -SIMTIME_DBL(classInfo->operator [](cNum-1).ton) * log(content_stream::open_unit(stream.at(k)));
 }
 
 /*
- * 	Check the state of the specified content.
- *
- * 	Parameters:
- * 	- contentID: ID of the specified content.
+ * 	Current ON window of the content 'ID' (global ID) of class 'cNum'. The first
+ * 	window of a content is generated the first time it is requested; when
+ * 	ON_OFF_DENSE contents of its page have been requested, the page moves from
+ * 	sparse_windows to an array (the contents not requested yet get their first
+ * 	window). References to the windows in sparse_windows stay valid on rehash.
  */
-bool ShotNoiseContentDistribution::check_state_flag(int contentID)
+ShotNoiseContentDistribution::on_window &ShotNoiseContentDistribution::window(int cNum, name_t ID)
 {
-	bool active = false;
-	if ((uint32_t)contentID < state_flags->size())
+	unsigned long local = ID - classInfo->operator [](cNum-1).mostPopular;
+	on_off_page &page = on_off_pages[cNum-1][local / ON_OFF_PAGE];
+	if (page.dense)
+		return page.dense[local % ON_OFF_PAGE];
+
+	if (page.sparse < ON_OFF_DENSE)
 	{
-		if(state_flags->operator[](contentID) == 1)
-		active = true;
+		pair<boost::unordered_map<name_t, on_window>::iterator, bool> e = sparse_windows.insert(make_pair(ID, on_window()));
+		if (e.second)
+		{
+			e.first->second.end = on_duration(cNum, ID, 0);
+			e.first->second.k = 0;
+			page.sparse++;
+		}
+		return e.first->second;
 	}
-	else
-		cout << "Trying to check the state flag of a non existent content!\n";
-	return active;
 
+	page.dense = new on_window[ON_OFF_PAGE];
+	name_t first = ID - local % ON_OFF_PAGE;
+	for (unsigned j = 0; j < ON_OFF_PAGE; j++)
+	{
+		boost::unordered_map<name_t, on_window>::iterator it = sparse_windows.find(first + j);
+		if (it != sparse_windows.end())
+		{
+			page.dense[j] = it->second;
+			sparse_windows.erase(it);
+		}
+		else
+		{
+			page.dense[j].end = on_duration(cNum, first + j, 0);
+			page.dense[j].k = 0;
+		}
+	}
+	page.sparse = 0;
+	allocated_pages++;
+	return page.dense[local % ON_OFF_PAGE];
 }
 
 /*
- * 	Set the transition time of the specified content.
- *
- * 	Parameters:
- * 	- contentID: ID of the specified content.
- * 	- timeStamp: new transition time for contentID.
+ * 	Check whether the content 'ID' (global ID) of class 'cNum' is ON at time 'now',
+ * 	moving its window forward if needed. Requests come in time order, so windows
+ * 	are only generated forward.
  */
-void ShotNoiseContentDistribution::set_state_time(int contentID, simtime_t timeStamp)
+bool ShotNoiseContentDistribution::is_on(int cNum, name_t ID, simtime_t now)
 {
-	if ((uint32_t)contentID < state_flags->size())
-		state_times->operator[](contentID) = timeStamp;
-	else
-		cout << "Trying to set the transition time of a non existent content!\n";
-}
+	if (!on_off_class(cNum))
+		return true;
 
-/*
- * 	Check the transition time of the specified content.
- *
- * 	Parameters:
- * 	- contentID: ID of the specified content.
- */
-simtime_t ShotNoiseContentDistribution::get_state_time(int contentID)
-{
-	simtime_t temp;
-	if ((uint32_t)contentID < state_flags->size())
-		temp = state_times->operator[](contentID);
-	else
-		cout << "Trying to get the transition time of a non existent content!\n";
-	return temp;
+	on_window &w = window(cNum, ID);
+	double t = SIMTIME_DBL(now);
+	double toff = SIMTIME_DBL(classInfo->operator [](cNum-1).toff);
+	while (t > w.end)
+	{
+		w.k++;
+		w.end += toff + on_duration(cNum, ID, w.k);
+	}
+	return t >= w.end - on_duration(cNum, ID, w.k);
 }
-
@@ -219,13 +219,6 @@ void WeightedContentDistribution::finalize_total_replica(){
 
 
 
-// Override content_distribution::binary_strings(..)
-vector<unsigned short> WeightedContentDistribution::binary_strings(int num_ones,int len){
-	// Do nothing as we don't need this in this case
-	vector<unsigned short> v;
-	return v;
-}
-
 // The repository with bigger weight will have the more contents
 //		PAY ATTENTION: 
 //			- Verify the correctness of catalog_split before calling
@@ -33,16 +33,28 @@
 #include "ShotNoiseContentDistribution.h"
 #include "zipf.h"
 #include "zipf_sampled.h"
+#include "philox_rng.h"
 #include <algorithm>
+#include <thread>
 #include <boost/tokenizer.hpp>
 
 #include <error_handling.h>
+#include "diag_log.h"
 
 Register_Class(content_distribution);
 
 
 vector<file> content_distribution::catalog;
 
+bool content_distribution::procedural = false;
+uint64_t content_distribution::catalog_seed = 0;
+double content_distribution::geometric_scale = 0;
+int content_distribution::catalog_replicas = 1;
+int content_distribution::catalog_repos = 1;
+bool content_distribution::repo_table = false;
+vector<unsigned short> content_distribution::replica_members;
+unsigned long content_distribution::num_replica_sets = 0;
+
 vector<zipf_sampled*>  content_distribution::zipf;
 
 name_t  content_distribution::stabilization_bulk = 0;
@@ -58,7 +70,7 @@ int content_distribution::num_repos;
 // Initialize catalog, repositories, and distribute contents among them.
 void content_distribution::initialize()
 {
-	cout << "CONTENT DISTRIBUTION" << endl;
+	DIAG(DIAG_INFO, diag_out) << "CONTENT DISTRIBUTION" << endl;
 
     nodes = getAncestorPar("n");
     num_repos = getAncestorPar("num_repos"); // Number of repositories (specifically ccn_node(s) which have a repository connected to them)
@@ -87,16 +99,16 @@ void content_distribution::initialize()
     		// Take parameters from the .ini file
 
     		unsigned long cardF_temp = par("objects");		// Total number of contents in the original non-downscaled system.
-    		cout << " ------- CARDINALITY from ContentDistribution Par:\t" << cardF_temp << " -------" << endl;
+    		DIAG(DIAG_INFO, diag_out) << " ------- CARDINALITY from ContentDistribution Par:\t" << cardF_temp << " -------" << endl;
 
     		cardF = (unsigned long long)cardF_temp;
-    		cout << " ------- CARDINALITY from ContentDistribution After conversion:\t" << cardF << " -------" << endl;
+    		DIAG(DIAG_INFO, diag_out) << " ------- CARDINALITY from ContentDistribution After conversion:\t" << cardF << " -------" << endl;
 
 
     		// Retrieve the downscaling factor in order to compute the new cardinality
 
     		down = pSubModStat->par("downsize");
-    		cout << " ------- DOWN from ContentDistribution After Par:\t" << down << " -------" << endl;
+    		DIAG(DIAG_INFO, diag_out) << " ------- DOWN from ContentDistribution After Par:\t" << down << " -------" << endl;
     		double lambda = pSubModStat->par("lambda");
 
     		// Init debug file used with Akaroa (declared in statistics.h)
@@ -105,7 +117,7 @@ void content_distribution::initialize()
 
     		// Downscaled catalog cardinality.
     		newCardF = round(cardF*(1./(double)down));
-    		cout << " ------- DOWNSCALED CARDINALITY from ContentDistribution:\t" << cardF << " -------" << endl;
+    		DIAG(DIAG_INFO, diag_out) << " ------- DOWNSCALED CARDINALITY from ContentDistribution:\t" << cardF << " -------" << endl;
 
     		zipf.resize(1);
     		// Initialize the rejection-inversion sampling in order to generate random numbers that
@@ -120,7 +132,7 @@ void content_distribution::initialize()
     		perfile_bulk = cardF;  		// In case the Shot Noise Model is simulated, we have to gather statistics
     									// for all the content in the catalog (a clear correspondence with the
     									// IRM model with a single big catalog is still missing).
-    		cout << "ShotNoise CARDINALITY: " << cardF;
+    		DIAG(DIAG_INFO, diag_out) << "ShotNoise CARDINALITY: " << cardF;
     		zipf.resize(1);
     		zipf[0] = new zipf_sampled((unsigned long long)newCardF,alpha,lambda,1);  // Zipf with rejection-inversion sampling
     	}
@@ -138,7 +150,11 @@ void content_distribution::initialize()
     *(content_distribution::total_replicas_p) = 0;
 
 
-    catalog.resize(newCardF+1); 	// Initialize content catalog.
+    procedural = par("procedural_catalog");
+    if (procedural && !independent_placement())
+    	error("content_distribution: the procedural catalog needs a replica placement that does not depend on the previous contents");
+    if (!procedural)
+    	catalog.resize(newCardF+1); 	// Initialize content catalog.
 
 
     // *** Repositories initialization ***
@@ -171,9 +187,9 @@ void content_distribution::initialize()
 	initialize_repo_popularity();
 
     // *** Content initialization ***
-    cout<<"Start content initialization..."<<endl;
+    DIAG(DIAG_INFO, diag_out) << "Start content initialization..."<<endl;
     init_content();
-    cout<<"Content initialized"<<endl;
+    DIAG(DIAG_INFO, diag_out) << "Content initialized"<<endl;
 
 	finalize_total_replica();
 }
@@ -200,61 +216,45 @@ void content_distribution::verify_replica_number(){
 #endif
 
 
-/* 
- * Generate all possible combinations of binary strings of a given length with
- * a given number of bits set.
-*/
-vector<unsigned short> content_distribution::binary_strings(int num_ones,int len){
-
-		#ifdef SEVERE_DEBUG
-			if (num_ones <= 0){
-				std::stringstream ermsg; 
-				ermsg<<"You want a number of object replicas equal to "<<
-					num_ones<<". It is not valid";
-				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-			}
-		#endif
-
-	vector<unsigned short> bins;
-	unsigned short ones,bin;
-    for (int i =1;i< (1<<len);i++){
-		bin = i; 	// It is the binary string.
-		ones = 0;
-		// Count the number of ones
-		while (bin){
-			ones += bin & 1;
-			bin >>= 1;
-		}
-		// If the ones are equal to the number of repositories this is a good binary number
-		if (ones == num_ones)
-			bins.push_back(i);
-
-		#ifdef SEVERE_DEBUG
-			if (bins.size() == 0){
-				std::stringstream ermsg; 
-				ermsg<<"No binary strings were produced. The number of replicas for "<<
-					"each content should be "<<num_ones;
-				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
-			}
-		#endif
-    }
-    return bins;
-
+/*
+ * Choose 'k' distinct repositories among 'n', uniformly among all the k-of-n
+ * combinations, with Floyd's algorithm (k draws, whatever n). 'rnd(j)' must
+ * return a uniform integer in [0, j].
+ * The result has a 1 in the i-th position iff the i-th repo is chosen.
+ */
+template<class R> static repo_t choose_combination(int k, int n, R rnd)
+{
+	repo_t mask = 0;
+	for (int j = n - k; j < n; j++)
+	{
+		int t = rnd(j);
+		if (mask & ((repo_t)1 << t))
+			mask |= (repo_t)1 << j;
+		else
+			mask |= (repo_t)1 << t;
+	}
+	return mask;
 }
 
 // Return a string of bit representing an object placement.
 // There is a 1 in the i-th position iff the object is served by the i-th repo
+// (or, with more than MAX_BITMASK_REPOS repos, the index of the replica set).
 unsigned short content_distribution::choose_repos (int object_index )
 {
-	unsigned short repo_string = repo_strings[intrand(repo_strings.size())];
+	unsigned short repo_string;
+	if (repo_table)
+		repo_string = intrand(num_replica_sets);
+	else
+		repo_string = choose_combination(replicas, num_repos, [this](int j){return (int)intrand(j+1);});
 
 	#ifdef SEVERE_DEBUG
-	int num_1_bits =  __builtin_popcount (repo_string); //http://stackoverflow.com/a/109069
-												// Number of bits set to 1 (corresponding 
-												// to the number of repositories this object was 
+	int num_1_bits = 0;
+	for_each_repo(repo_string, [&num_1_bits](int){num_1_bits++;});
+												// Number of bits set to 1 (corresponding
+												// to the number of repositories this object was
 												// assigned to)
 	if (num_1_bits != replicas){
-		std::stringstream ermsg; 
+		std::stringstream ermsg;
 		ermsg<<"an object has been assigned to "<< num_1_bits <<" repos while replicas="<<replicas;
 	    severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
 	}
@@ -265,80 +265,201 @@ unsigned short content_distribution::choose_repos (int object_index )
 	return repo_string;
 }
 
+/*
+ * Build the table of the replica sets, used when there are more repositories
+ * than the bits of repo_t. If there are at most 2^16 combinations of
+ * 'replicas' repositories, the table holds all of them (in lexicographic
+ * order), so that drawing a uniform index draws a uniform placement.
+ * Otherwise it holds 2^16 combinations drawn uniformly (Floyd's algorithm)
+ * from the RNG of the module, and the placement of each content is uniform
+ * among them.
+ */
+void content_distribution::init_replica_sets()
+{
+	repo_table = num_repos > MAX_BITMASK_REPOS;
+	replica_members.clear();
+	num_replica_sets = 0;
+	if (!repo_table)
+		return;
+
+	if (!independent_placement()){
+		std::stringstream ermsg;
+		ermsg<<"This content distribution supports at most "<<MAX_BITMASK_REPOS<<" repositories, while num_repos="<<num_repos;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	const unsigned long max_sets = (unsigned long)REPO_MSK + 1;
+	// Number of combinations, stopping as soon as it exceeds the table.
+	unsigned long combinations = 1;
+	for (int j = 1; j <= replicas && combinations <= max_sets; j++)
+		combinations = combinations * (num_repos - replicas + j) / j;
+
+	if (combinations <= max_sets)
+	{
+		num_replica_sets = combinations;
+		replica_members.reserve(num_replica_sets * replicas);
+		vector<unsigned short> c(replicas);
+		for (int j = 0; j < replicas; j++)
+			c[j] = j;
+		for (unsigned long r = 0; r < num_replica_sets; r++)
+		{
+			replica_members.insert(replica_members.end(), c.begin(), c.end());
+			// Next combination: increase the rightmost index that can grow.
+			int j = replicas - 1;
+			while (j >= 0 && c[j] == num_repos - replicas + j)
+				j--;
+			if (j < 0)
+				break;
+			c[j]++;
+			for (int i = j + 1; i < replicas; i++)
+				c[i] = c[i-1] + 1;
+		}
+	}
+	else
+	{
+		num_replica_sets = max_sets;
+		replica_members.reserve(num_replica_sets * replicas);
+		vector<int> c(replicas);
+		for (unsigned long r = 0; r < num_replica_sets; r++)
+		{
+			// Floyd's algorithm on the repository indices.
+			for (int j = num_repos - replicas, n = 0; j < num_repos; j++, n++)
+			{
+				int t = intrand(j+1);
+				c[n] = std::find(c.begin(), c.begin() + n, t) != c.begin() + n ? j : t;
+			}
+			std::sort(c.begin(), c.end());
+			replica_members.insert(replica_members.end(), c.begin(), c.end());
+		}
+	}
+	DIAG(DIAG_INFO, diag_out) << "Replica sets: "<<num_replica_sets<<" sets of "<<replicas<<" among "<<num_repos<<" repositories"<<endl;
+}
+
+// Number of contents handled as a unit by the threads of init_content().
+#define CATALOG_CHUNK 65536
+
 //	Store information about the content.
 void content_distribution::init_content()
 {
 	// In repo_card we count how many objects each repo is storing.
-	vector<int> repo_card(num_repos,0); 
+	vector<long> repo_card(num_repos,0);
 
-    // As the repositories are represented as a string of bits, the function
-    // binary_string is used for generating binary strings of length num_repos
-    // with exactly replicas ones, where "replicas" is the number of replicas for each object.
-	// Each string represents a replica placement of a certain object among the repositories.
-	// Given a single string, a 1 in the i-th position means that a replica of that object
-	// is placed in the i-th repository.
-    repo_strings = binary_strings(replicas, num_repos);
+	if (independent_placement() && (replicas < 1 || replicas > num_repos)){
+		std::stringstream ermsg;
+		ermsg<<"Each content should have "<<replicas<<" replicas among "<<num_repos<<" repositories";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
 
-    for (int d = 1; d <= (int)newCardF; d++)
-    {
-    	// 'd' is a content.
-		// Reset the information field of a given content
-		__info(d) = 0;
-
-		// F is the size of a file.
-		if (F > 1){
-			// Set the file size (geometrically distributed).
-			filesize_t s = geometric( 1.0 / F ) + 1;
-			__ssize ( d, s );
-		}else 
-			__ssize( d , 1);
-
-		vector<int> chosen_repos; 
-
-		// Set the repositories.
-		if (num_repos==1){
-			__srepo ( d , 1 );
-			// Compute the chosen_repo
-			chosen_repos.push_back(0);
-		} else {
-			// Choose a replica placement among all the possible ones.
-			// repos is a replica placement.
-			repo_t repos = choose_repos(d);
-			__srepo (d ,repos);
+	// The size and the replica placement of each content are drawn from the
+	// stream of the content (see procedural_info()).
+	cRNG *rng = philox_rng::module_stream(this);
+	catalog_seed = ((uint64_t)rng->intRand() << 32) ^ rng->intRand();
+	geometric_scale = F > 1 ? 1.0 / log(1.0 - 1.0/F) : 0;
+	catalog_replicas = replicas;
+	catalog_repos = num_repos;
+	init_replica_sets();
 
-			// Compute the chosen_repos
-			repo_t repo_extracted = __repo(d);
-			unsigned k = 0;
-			while (repo_extracted)
+	if (procedural)
+	{
+		// Nothing is stored: the repo-*_card scalars record the expected
+		// number of contents per repository.
+		for (int repo_idx = 0; repo_idx < num_repos; repo_idx++)
+			repo_card[repo_idx] = round((double)newCardF * replicas / num_repos);
+	}
+	else if (independent_placement())
+	{
+		// Contents are split in chunks, dealt round robin to the threads. Each
+		// content only depends on its own stream, so the catalog is the same
+		// for any number of threads.
+		unsigned int threads = par("init_threads");
+		if (threads == 0)
+			threads = std::thread::hardware_concurrency();
+		if (threads == 0)
+			threads = 1;
+		unsigned long numChunks = newCardF / CATALOG_CHUNK + 1;
+		vector<vector<long> > partial_card(threads, vector<long>(num_repos, 0));
+
+		auto worker = [&](unsigned int first) {
+			vector<long> &card = partial_card[first];
+			for (unsigned long c = first; c < numChunks; c += threads)
 			{
-				if (repo_extracted & 1)
+				name_t lo = c*CATALOG_CHUNK > 0 ? c*CATALOG_CHUNK : 1;
+				name_t hi = min((unsigned long)(c+1)*CATALOG_CHUNK, newCardF+1);
+				for (name_t d = lo; d < hi; d++)
 				{
-					chosen_repos.push_back(k);
-					//cout << "Content # " << d << " in Repo # " << repositories[k] << endl;
+					__info(d) = procedural_info(d);
+					for_each_repo(__repo(d), [&card](int k){card[k]++;});
 				}
-				repo_extracted >>= 1;
-				k++;
 			}
-		}
+		};
+		vector<std::thread> pool;
+		for (unsigned int t = 1; t < threads; t++)
+			pool.push_back(std::thread(worker, t));
+		worker(0);
+		for (size_t t = 0; t < pool.size(); t++)
+			pool[t].join();
+
+		for (unsigned int t = 0; t < threads; t++)
+			for (int repo_idx = 0; repo_idx < num_repos; repo_idx++)
+				repo_card[repo_idx] += partial_card[t][repo_idx];
 
-		// Update the repository cardinality
-		for (unsigned repo_idx = 0; repo_idx < chosen_repos.size(); repo_idx++)
-					repo_card[ chosen_repos[repo_idx] ] ++;
+		#ifdef SEVERE_DEBUG
+		*total_replicas_p = newCardF*replicas;
+		#endif
+	}
+	else
+	{
+		// The placement depends on the previous contents (e.g., in
+		// WeightedContentDistribution): sequential initialization.
+		for (name_t d = 1; d <= newCardF; d++)
+		{
+			// 'd' is a content.
+			// Reset the information field of a given content, and set its size
+			// and its repositories.
+			__info(d) = procedural_info(d) & SIZE_MSK;
+			repo_t repos = num_repos == 1 ? 1 : choose_repos(d);
+			__srepo (d ,repos);
 
-    }
+			// Update the repository cardinality
+			for_each_repo(repos, [&repo_card](int k){repo_card[k]++;});
+		}
+	}
 
 	// Record the repository cardinality and price
 	for (int repo_idx = 0; repo_idx < num_repos; repo_idx++){
-	    char name[15];
+	    char name[32];
 		sprintf(name,"repo-%d_card",repo_idx);
 		recordScalar(name, repo_card[repo_idx] );
 
 		sprintf(name,"repo-%d_price",repo_idx);
-		recordScalar(name, repo_prices[repo_idx] ); 
+		recordScalar(name, repo_prices[repo_idx] );
 
 	}
 }
 
+info_t content_distribution::procedural_info(name_t f)
+{
+	content_stream stream(catalog_seed, f);
+
+	// Same inversion as geometric(1/F): floor(log(U)/log(1-1/F)), with U in (0,1).
+	info_t size = 1;
+	if (geometric_scale != 0)
+	{
+		double u = content_stream::open_unit(stream.next());
+		size = (info_t)floor(geometric_scale * log(u)) + 1;
+	}
+	else
+		stream.next();
+
+	info_t repos;
+	if (repo_table)
+		repos = stream.bounded(num_replica_sets - 1);
+	else
+		repos = choose_combination(catalog_replicas, catalog_repos, [&stream](int j){return stream.bounded(j);});
+
+	return ((size << SIZE_OFFSET) & SIZE_MSK) | ((repos << REPO_OFFSET) & REPO_MSK);
+}
+
 /*
 * Initialize the repositories vector. This vector is composed of the
 * repositories specified in the ini file.  In addition some random repositories
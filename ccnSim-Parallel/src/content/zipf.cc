@@ -40,11 +40,10 @@ using namespace std;
 void zipf_distribution::zipf_initialize(){
 
 	// Return if the cdf has been already initialized.
-    if (cdfZipf.size() != 0)
+    if (cdfZipf.size() != 0 || cdfCompact.size() != 0)
     	return;
 
     double c = 0;
-    double num = 0;
 
     cout<<"Initializing Zipf distribution of Class # "<< class_num << " ..."<<  endl;
 
@@ -58,15 +57,49 @@ void zipf_distribution::zipf_initialize(){
 
     cout << "Chosen percentile:\t" << perc_aggr << "\n";
 
+    // In compact mode the single precision cdf is filled directly, so that the
+    // double precision one is never allocated.
+    if (compact)
+    {
+    	build_cdf(cdfCompact);
+    	if (cdfCompact.size() != 0)
+    	{
+    		unsigned int ties = 0;
+    		for (uint32_t i=2; i<cdfCompact.size(); i++)
+    			if (cdfCompact[i] == cdfCompact[i-1])
+    				ties++;
+    		cout << "Single precision cdf:\t" << ties << " contents not distinguishable from the previous one\n";
+    		build_guide(cdfCompact);
+    	}
+    }
+    else
+    {
+    	build_cdf(cdfZipf);
+    	if (cdfZipf.size() != 0)
+    		build_guide(cdfZipf);
+    }
+
+    cout<<"Zipf initialization completed"<<endl;
+}
+
+/*
+ * 	Fill the cdf according to the percentile for the catalog aggregation. The
+ * 	partial sums are kept in double precision whatever the type of the entries.
+ */
+template<class T> void zipf_distribution::build_cdf(vector<T> &cdf)
+{
+    double c = normalization_constant;
+    double num = 0;
+
     if (perc_aggr == 1.0)  		// The catalog is not aggregated.
     {
-    	cdfZipf.resize(F+1);
-    	cdfZipf[0] = -1;
+    	cdf.resize(F+1);
+    	cdf[0] = -1;
 
     	for (int i=1; i<=F; i++)
     	{
     		num += (1.0 / pow(i+q,alpha));
-    		cdfZipf[i] = num*c;
+    		cdf[i] = num*c;
     	}
     }
     else if (perc_aggr > 0 && perc_aggr < 1.0)  // Catalog aggregation after the perc_aggr-th percentile.
@@ -81,18 +114,18 @@ void zipf_distribution::zipf_initialize(){
     			ID_aggr = i;
     			num=0;
     			cout << "\nContent ID of correspondent to the chosen percentile:\t" << ID_aggr << "\n";
-    			cdfZipf.resize(ID_aggr+2);
-    			cdfZipf[0] = -1;
+    			cdf.resize(ID_aggr+2);
+    			cdf[0] = -1;
     			for (uint32_t j=1; j<=ID_aggr+1; j++)
     			{
     				num += (1.0 / pow(j+q,alpha));
     				if(j<ID_aggr+1)
-    					cdfZipf[j] = num*c;
+    					cdf[j] = num*c;
     				else
-    					cdfZipf[j] = 1;
+    					cdf[j] = 1;
     			}
-    			cout << "Size of the cdf vector:\t" << cdfZipf.size() << "\n";
-    			cout << "Last two values of the cdf:\t" << cdfZipf[ID_aggr] << "\t" << cdfZipf[ID_aggr+1] << "\n";
+    			cout << "Size of the cdf vector:\t" << cdf.size() << "\n";
+    			cout << "Last two values of the cdf:\t" << cdf[ID_aggr] << "\t" << cdf[ID_aggr+1] << "\n";
     			break;
     		}
     	}
@@ -101,8 +134,46 @@ void zipf_distribution::zipf_initialize(){
     {
     	cout << "Insert a percentile value < 1!";
     }
+}
 
-    cout<<"Zipf initialization completed"<<endl;
+// Number of cdf entries per entry of the guide table, i.e., the expected
+// number of entries scanned by value().
+#define ZIPF_GUIDE_RATIO 4
+
+/*
+ * 	The guide table splits [0,1] in equal intervals and stores, for each of them,
+ * 	the first content whose cdf reaches the interval, so that value() starts the
+ * 	search next to the result. The thresholds are compared as cdf*size >= i, i.e.,
+ * 	with the same rounding used by value() to pick the interval.
+ */
+template<class T> void zipf_distribution::build_guide(const vector<T> &cdf)
+{
+	size_t size = cdf.size()/ZIPF_GUIDE_RATIO;
+	if (size == 0)
+		size = 1;
+	guide.resize(size);
+
+	uint32_t y = 0;
+	uint32_t last = cdf.size()-1;
+	for (size_t i=0; i<size; i++)
+	{
+		while (y < last && (double)cdf[y]*size < i)
+			y++;
+		guide[i] = y;
+	}
+}
+
+template<class T> unsigned int zipf_distribution::guided_search(const vector<T> &cdf, double p)
+{
+	size_t i = p > 0 ? (size_t)(p*guide.size()) : 0;
+	if (i >= guide.size())
+		i = guide.size()-1;
+
+	uint32_t y = guide[i];
+	uint32_t last = cdf.size()-1;
+	while (y < last && cdf[y] < p)
+		y++;
+	return y;
 }
 
 double zipf_distribution::get_normalization_constant(){
@@ -125,33 +196,12 @@ double zipf_distribution::get_perc_aggr()
 }
 
 /*
- * 	Binary search within the Zipf cdf.
+ * 	Inversion of the Zipf cdf, starting from the guide table.
  */
 unsigned int zipf_distribution::value(double p){
-
-    unsigned int upper, lower,atry, last_try;
-    
-    lower = -1;
-    upper = cdfZipf.size()-1;
-    atry = -1;
-    last_try = -1;
-
-    // Binary search to find the nearest value y whose cdf is x
-    while (1){
-		atry = floor((lower+upper+1)/2);
-
-		if (last_try == atry)
-			break;
-
-		if (cdfZipf[atry] >= p)
-			upper=atry;
-		else
-			lower = atry-1;
-
-		last_try = atry;
-    }
-
-    return upper;
+	if (compact)
+		return guided_search(cdfCompact, p);
+	return guided_search(cdfZipf, p);
 }
 
 double zipf_distribution::get_alpha()
@@ -38,6 +38,7 @@
 #include "zipf_sampled.h"
 #include <iostream>
 #include <cmath>
+#include <thread>
 
 #include "ccnsim.h"
 #include "client.h"
@@ -62,7 +63,7 @@ unsigned long long zipf_sampled::sample()
     {
     	double rd;
     	if(cSimulation::getActiveSimulation()->getContext())
-    		rd = cSimulation::getActiveSimulation()->getContext()->getRNG(0)->doubleRand();
+    		rd = philox_rng::module_stream(cSimulation::getActiveSimulation()->getContext())->doubleRand();
     	else
     		rd = cSimulation::getActiveEnvir()->getRNG(0)->doubleRand();
     	double u = hIntegralNumberOfElements + rd * (hIntegralX1 - hIntegralNumberOfElements);
@@ -125,6 +126,150 @@ unsigned long long zipf_sampled::sample()
     }
 }
 
+/*
+ * Batched version of sample(): all the candidates of a round are drawn first,
+ * then inverted together, then tested. Each candidate goes through the same
+ * arithmetic as in sample(), and the accepted ones are kept in the order in
+ * which they were drawn, so the output has the same distribution (and, given
+ * the same random numbers, the same values) as successive calls of sample().
+ */
+void zipf_sampled::sample(cRNG *rng, unsigned long long *out, unsigned int count)
+{
+	if (batch_u.size() < count)
+	{
+		batch_u.resize(count);
+		batch_x.resize(count);
+	}
+	double *u = batch_u.data();
+	double *x = batch_x.data();
+	double uRange = hIntegralX1 - hIntegralNumberOfElements;
+	double oneMinusExp = 1.0 - exponent;
+
+	unsigned int filled = 0;
+	while (filled < count)
+	{
+		unsigned int n = count - filled;
+
+		for (unsigned int i = 0; i < n; i++)
+			u[i] = hIntegralNumberOfElements + rng->doubleRand() * uRange;
+
+		// hIntegralInverse(u), with helper1() inlined; the inner loop still
+		// branches on |t| and calls log()/exp() per element.
+		for (unsigned int i = 0; i < n; i++)
+		{
+			double t = u[i] * oneMinusExp;
+			t = t < -1.0 ? -1.0 : t;
+			double h1 = abs(t) > 1e-8 ? log(1.0+t)/t : 1.-t*((1./2.)-t*((1./3.)-t*(1./4.)));
+			x[i] = exp(h1 * u[i]);
+		}
+
+		for (unsigned int i = 0; i < n; i++)
+		{
+			unsigned long long k = (unsigned long long)(x[i] + 0.5);
+			if (k < 1)
+				k = 1;
+			else if (k > numberOfElements)
+				k = numberOfElements;
+			// See sample() for the acceptance condition.
+			if (k - x[i] <= s || u[i] >= hIntegral(k + 0.5) - h(k))
+				out[filled++] = k;
+		}
+	}
+}
+
+/*
+ * Meta-content j collects the contents k with floor(k/down)+1 == j, so its
+ * bin is [(j-1)*down, j*down-1] (the first bin starts from 1). The last
+ * content (k = numberOfElements) is assigned to the last bin.
+ * The alias table is built with Vose's method.
+ */
+void zipf_sampled::build_bin_table()
+{
+	unsigned long n = newCard;
+	vector<double> scaled(n);
+	double total = 0;
+	for (unsigned long j = 0; j < n; j++)
+	{
+		unsigned long long lo = j*(unsigned long long)down;
+		unsigned long long hi = (j == n-1) ? numberOfElements : lo + down - 1;
+		scaled[j] = harmonicSum(lo < 1 ? 1 : lo, hi, exponent);
+		total += scaled[j];
+	}
+
+	bin_prob.resize(n);
+	bin_alias.resize(n);
+	vector<unsigned long> small, large;
+	for (unsigned long j = 0; j < n; j++)
+	{
+		scaled[j] *= n / total;
+		if (scaled[j] < 1.0)
+			small.push_back(j);
+		else
+			large.push_back(j);
+	}
+	while (!small.empty() && !large.empty())
+	{
+		unsigned long l = small.back();
+		unsigned long g = large.back();
+		small.pop_back();
+		bin_prob[l] = scaled[l];
+		bin_alias[l] = g;
+		scaled[g] = (scaled[g] + scaled[l]) - 1.0;
+		if (scaled[g] < 1.0)
+		{
+			large.pop_back();
+			small.push_back(g);
+		}
+	}
+	// What is left has probability 1 (up to rounding errors).
+	for (size_t i = 0; i < large.size(); i++)
+	{
+		bin_prob[large[i]] = 1.0;
+		bin_alias[large[i]] = large[i];
+	}
+	for (size_t i = 0; i < small.size(); i++)
+	{
+		bin_prob[small[i]] = 1.0;
+		bin_alias[small[i]] = small[i];
+	}
+}
+
+void zipf_sampled::sample_meta(cRNG *rng, unsigned long long *out, unsigned int count)
+{
+	if (bin_prob.empty())
+		build_bin_table();
+
+	double n = (double)bin_prob.size();
+	for (unsigned int i = 0; i < count; i++)
+	{
+		// The integer part of the random number picks the column, the
+		// fractional part decides between the column and its alias.
+		double r = rng->doubleRand() * n;
+		unsigned long j = (unsigned long)r;
+		if (j >= bin_prob.size())
+			j = bin_prob.size() - 1;
+		out[i] = ((r - j) < bin_prob[j] ? j : bin_alias[j]) + 1;
+	}
+}
+
+void zipf_prefetch::init(zipf_sampled *z, cRNG *r, unsigned int size, bool metaContents)
+{
+	sampler = z;
+	rng = r;
+	meta = metaContents;
+	buffer.resize(size > 0 ? size : 1);
+	next = buffer.size();		// Filled at the first request.
+}
+
+void zipf_prefetch::refill()
+{
+	if (meta)
+		sampler->sample_meta(rng, buffer.data(), buffer.size());
+	else
+		sampler->sample(rng, buffer.data(), buffer.size());
+	next = 0;
+}
+
 double zipf_sampled::hIntegral(double x)
 {
     double logX = log(x);
@@ -177,11 +322,83 @@ double zipf_sampled::helper2(double x)
 
 double zipf_sampled::generalizedHarmonic(unsigned long long n_t, double m)
 {
-    double value = 0;
-    double n = (double)n_t;
-    for (double k = n; k > 0; --k)
+    return harmonicSum(1, n_t, m);
+}
+
+// Number of leading terms of harmonicSum() that are added up one by one.
+#define ZIPF_EXACT_TERMS 1024
+
+double zipf_sampled::harmonicSum(unsigned long long a, unsigned long long b, double m)
+{
+    double sum = 0;
+    unsigned long long k = b < ZIPF_EXACT_TERMS-1 ? b : ZIPF_EXACT_TERMS-1;
+    for (; k >= a && k > 0; k--)		// Smallest terms first.
+        sum += exp(-m*log((double)k));
+    if (a < ZIPF_EXACT_TERMS)
+        a = ZIPF_EXACT_TERMS;
+    if (a > b)
+        return sum;
+
+    // Euler-Maclaurin: integral of f(x) = x^-m over [a, b], plus the correction
+    // terms with f'(x) = -m*x^(-m-1) and f'''(x) = -m*(m+1)*(m+2)*x^(-m-3).
+    // The integral (b^(1-m) - a^(1-m))/(1-m) is computed as
+    // a^(1-m) * log(b/a) * helper2((1-m)*log(b/a)), which does not lose
+    // precision when b/a is close to 1 (and gives log(b/a) for m = 1).
+    double x = (double)a;
+    double y = (double)b;
+    double fx = exp(-m*log(x));
+    double fy = exp(-m*log(y));
+    double logRatio = log1p((y - x)/x);
+    double integral = fx * x * logRatio * helper2((1.0-m)*logRatio);
+    double d1 = -m*(fy/y - fx/x);
+    double d3 = -m*(m+1)*(m+2)*(fy/(y*y*y) - fx/(x*x*x));
+    return integral + (fx + fy)/2 + d1/12 - d3/720 + sum;
+}
+
+double zipf_sampled::generalizedHarmonicExact(unsigned long long n_t, double m, unsigned int threads)
+{
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+
+    // The range is split in fixed blocks (independently of the number of
+    // threads), each one summed from its end with Kahan's compensation;
+    // the partial sums are then added up in a fixed order.
+    const unsigned long long block = 1ULL << 20;
+    unsigned long long numBlocks = (n_t + block - 1) / block;
+    vector<double> partial(numBlocks, 0.0);
+
+    auto worker = [&](unsigned int first) {
+        for (unsigned long long b = first; b < numBlocks; b += threads)
+        {
+            unsigned long long lo = b*block + 1;
+            unsigned long long hi = min(n_t, (b+1)*block);
+            double sum = 0, c = 0;
+            for (unsigned long long k = hi; k >= lo; k--)
+            {
+                double term = exp(-m*log((double)k)) - c;
+                double t = sum + term;
+                c = (t - sum) - term;
+                sum = t;
+            }
+            partial[b] = sum;
+        }
+    };
+    vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+        pool.push_back(std::thread(worker, t));
+    worker(0);
+    for (size_t t = 0; t < pool.size(); t++)
+        pool[t].join();
+
+    double value = 0, c = 0;
+    for (unsigned long long b = numBlocks; b > 0; b--)
     {
-        value += 1.0 / pow(k, m);
+        double term = partial[b-1] - c;
+        double t = value + term;
+        c = (t - value) - term;
+        value = t;
     }
     return value;
 }
@@ -0,0 +1,359 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "diag_log.h"
+#include "error_handling.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <signal.h>
+
+using namespace std;
+
+#define DIAG_RING (1 << 16)			// Bytes queued by each thread.
+#define DIAG_PERIOD 20				// Milliseconds between two writes.
+
+/*
+ * Queue of the lines of a thread: a single-producer single-consumer ring of
+ * records [sink, length, text]. The producer only moves 'head' and the
+ * consumer only moves 'tail'.
+ */
+struct diag_ring{
+	alignas(64) atomic<uint64_t> head;
+	alignas(64) atomic<uint64_t> tail;
+	char data[DIAG_RING];
+
+	diag_ring():head(0),tail(0){;}
+};
+
+struct diag_record{
+	uint32_t sink;
+	uint32_t length;
+};
+
+// Streambuf appending to the pending line of a sink.
+class line_buf: public streambuf{
+	public:
+		string *line;
+	protected:
+		int overflow(int c)
+		{
+			if (c != EOF)
+				line->push_back((char)c);
+			return c;
+		}
+		streamsize xsputn(const char *s, streamsize n)
+		{
+			line->append(s, n);
+			return n;
+		}
+};
+
+struct diag_thread{
+	diag_ring *ring;
+	string pending[DIAG_SINKS];
+	line_buf buf;
+	ostream os;
+
+	diag_thread():ring(NULL),os(&buf){;}
+};
+
+static FILE *sinks[DIAG_SINKS];
+static vector<diag_ring *> rings;
+
+// The consumer side (writer thread, flush, fork, exit) and the registrations
+// are serialized; the producers never take it.
+static mutex consumer_lock;
+static condition_variable wake;
+static thread writer;
+static atomic<bool> writer_running(false);
+static bool writer_stop = false;
+static bool exiting = false;			// After exit(), the lines are written at once.
+
+diag_stream diag_out(stdout);
+
+// Never freed, as the lines of the main thread are written at exit.
+static diag_thread &own_thread()
+{
+	static thread_local diag_thread *t = new diag_thread();
+	return *t;
+}
+
+static void copy_out(const diag_ring *r, uint64_t from, char *to, size_t n)
+{
+	size_t at = from % DIAG_RING;
+	size_t first = min(n, (size_t)DIAG_RING - at);
+	memcpy(to, r->data + at, first);
+	memcpy(to + first, r->data, n - first);
+}
+
+static void copy_in(diag_ring *r, uint64_t to, const char *from, size_t n)
+{
+	size_t at = to % DIAG_RING;
+	size_t first = min(n, (size_t)DIAG_RING - at);
+	memcpy(r->data + at, from, first);
+	memcpy(r->data, from + first, n - first);
+}
+
+/*
+ * Writes the queued lines to their files. Called with consumer_lock held.
+ */
+static void drain()
+{
+	vector<char> text;
+	for (unsigned i = 0; i < rings.size(); i++)
+	{
+		diag_ring *r = rings[i];
+		uint64_t tail = r->tail.load(memory_order_relaxed);
+		uint64_t head = r->head.load(memory_order_acquire);
+		while (tail != head)
+		{
+			diag_record rec;
+			copy_out(r, tail, (char *)&rec, sizeof(rec));
+			text.resize(rec.length);
+			copy_out(r, tail + sizeof(rec), text.data(), rec.length);
+			if (sinks[rec.sink])
+				fwrite(text.data(), 1, rec.length, sinks[rec.sink]);
+			tail += sizeof(rec) + rec.length;
+		}
+		r->tail.store(tail, memory_order_release);
+	}
+	for (int s = 0; s < DIAG_SINKS; s++)
+		if (sinks[s])
+			fflush(sinks[s]);
+}
+
+static void write_loop()
+{
+	unique_lock<mutex> guard(consumer_lock);
+	while (!writer_stop)
+	{
+		wake.wait_for(guard, chrono::milliseconds(DIAG_PERIOD));
+		drain();
+	}
+}
+
+/*
+ * The writer is stopped before a fork (the engines are forked processes); it
+ * is restarted by the next queued line.
+ */
+static void stop_writer()
+{
+	unique_lock<mutex> guard(consumer_lock);
+	if (writer_running)
+	{
+		writer_stop = true;
+		guard.unlock();
+		wake.notify_one();
+		writer.join();
+		guard.lock();
+		writer_running = false;
+		writer_stop = false;
+	}
+	drain();
+}
+
+static void enqueue(int sink, const string &line);
+
+static void at_exit()
+{
+	diag_thread &t = own_thread();
+	for (int s = 0; s < DIAG_SINKS; s++)
+		if (!t.pending[s].empty())
+		{
+			enqueue(s, t.pending[s]);
+			t.pending[s].clear();
+		}
+	stop_writer();
+	lock_guard<mutex> guard(consumer_lock);
+	exiting = true;
+}
+
+// Called with consumer_lock held. The writer starts with all the signals
+// blocked, so that those awaited by the engine with sigwait() (the verdicts
+// of the Akaroa master) are never delivered to it.
+static void start_writer()
+{
+	static bool hooked = false;
+	if (!hooked)
+	{
+		pthread_atfork(stop_writer, NULL, NULL);
+		atexit(at_exit);
+		hooked = true;
+	}
+	sigset_t all, old;
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	writer = thread(write_loop);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	writer_running = true;
+}
+
+static void enqueue(int sink, const string &line)
+{
+	diag_thread &t = own_thread();
+	size_t size = sizeof(diag_record) + line.size();
+	if (t.ring == NULL || !writer_running.load() || size > DIAG_RING)
+	{
+		lock_guard<mutex> guard(consumer_lock);
+		void *mem;
+		if (t.ring == NULL && !exiting && posix_memalign(&mem, 64, sizeof(diag_ring)) == 0)
+		{
+			t.ring = new (mem) diag_ring();
+			rings.push_back(t.ring);
+		}
+		if (exiting || t.ring == NULL || size > DIAG_RING)		// Written at once, after the queued lines.
+		{
+			drain();
+			if (sinks[sink])
+			{
+				fwrite(line.data(), 1, line.size(), sinks[sink]);
+				fflush(sinks[sink]);
+			}
+			return;
+		}
+		if (!writer_running)
+			start_writer();
+	}
+
+	diag_ring *r = t.ring;
+	uint64_t head = r->head.load(memory_order_relaxed);
+	while (head + size - r->tail.load(memory_order_acquire) > DIAG_RING)
+	{
+		wake.notify_one();		// Full: wait for the writer.
+		this_thread::yield();
+	}
+	diag_record rec;
+	rec.sink = sink;
+	rec.length = line.size();
+	copy_in(r, head, (const char *)&rec, sizeof(rec));
+	copy_in(r, head + sizeof(rec), line.data(), line.size());
+	r->head.store(head + size, memory_order_release);
+	if (head + size - r->tail.load(memory_order_relaxed) > DIAG_RING/2)
+		wake.notify_one();
+}
+
+ostream &diag_stream::format(int sink)
+{
+	diag_thread &t = own_thread();
+	t.buf.line = &t.pending[sink];
+	return t.os;
+}
+
+void diag_stream::committed(int sink)
+{
+	string &line = own_thread().pending[sink];
+	if (!line.empty() && line[line.size()-1] == '\n')
+	{
+		enqueue(sink, line);
+		line.clear();
+	}
+}
+
+static int add_sink(FILE *file)
+{
+	lock_guard<mutex> guard(consumer_lock);
+	for (int s = 0; s < DIAG_SINKS; s++)
+		if (sinks[s] == NULL)
+		{
+			sinks[s] = file;
+			return s;
+		}
+	return -1;
+}
+
+diag_stream::diag_stream(FILE *file):owned(false)
+{
+	sink = add_sink(file);
+}
+
+void diag_stream::open(const char *path)
+{
+	close();
+	FILE *file = fopen(path, "w");
+	if (file == NULL)
+	{
+		std::stringstream ermsg;
+		ermsg<<"Unable to open "<<path;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+	sink = add_sink(file);
+	owned = true;
+	if (sink < 0)
+	{
+		std::stringstream ermsg;
+		ermsg<<"More than "<<DIAG_SINKS<<" diagnostic files are open";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+}
+
+/*
+ * The lines of the other threads must have been queued before.
+ */
+void diag_stream::flush()
+{
+	if (sink < 0)
+		return;
+	string &line = own_thread().pending[sink];
+	if (!line.empty())
+	{
+		enqueue(sink, line);
+		line.clear();
+	}
+	lock_guard<mutex> guard(consumer_lock);
+	drain();
+}
+
+void diag_stream::close()
+{
+	if (sink < 0)
+		return;
+	flush();
+	lock_guard<mutex> guard(consumer_lock);
+	if (owned)
+		fclose(sinks[sink]);
+	sinks[sink] = NULL;
+	sink = -1;
+	owned = false;
+}
+
+void diag_stream::flush_all()
+{
+	lock_guard<mutex> guard(consumer_lock);
+	drain();
+}
@@ -41,6 +41,7 @@
 #include "costaware_policy.h"
 #include "ideal_costaware_policy.h"
 #include "error_handling.h"
+#include "diag_log.h"
 
 #include "two_lru_policy.h"
 #include "two_ttl_policy.h"
@@ -116,8 +117,8 @@ void base_cache::initialize()
 	}
 	else if (decision_policy.find("btw")==0)				// Betweenness centrality
 	{
-		double db = getAncestorPar("betweenness");
-		if (fabs(db - 1)<=0.001)
+		double db = getAncestorPar("betweenness");	// Computed by the core layer, if not given.
+		if (db < 0)
 			error ("Node %i betweenness not defined.",getIndex());
 		decisor = new Betweenness(db);
     }
@@ -161,10 +162,11 @@ void base_cache::initialize()
 	}
 
     // Average Cache statistics
-    miss = 0;
-    hit = 0;
+    miss.clear();
+    hit.clear();
 
-	decision_yes = decision_no = 0;
+	decision_yes.clear();
+	decision_no.clear();
 
     //--Per file
 	//**mt** DISABLED
@@ -178,26 +180,29 @@ void base_cache::initialize()
 void base_cache::finish(){
 
     char name [30];
+    uint64_t hits = hit.value(), misses = miss.value();
+    uint64_t yes = decision_yes.value(), no = decision_no.value();
+
     sprintf ( name, "p_hit[%d]", getIndex());
-    recordScalar (name, hit * 1./(hit+miss));		// Record average hit rate.
+    recordScalar (name, hits * 1./(hits+misses));		// Record average hit rate.
 
 
     sprintf ( name, "hits[%d]", getIndex());		// Record number of hits.
-    recordScalar (name, hit );
+    recordScalar (name, hits );
 
 
     sprintf ( name, "misses[%d]", getIndex());		// Record number of misses.
-    recordScalar (name, miss);
+    recordScalar (name, misses);
 
     sprintf ( name, "decision_yes[%d]", getIndex());
-    recordScalar (name, decision_yes);
+    recordScalar (name, yes);
 
     sprintf ( name, "decision_no[%d]", getIndex());
-    recordScalar (name, decision_no);
+    recordScalar (name, no);
 
     sprintf ( name, "decision_ratio[%d]", getIndex());
-	double decision_ratio = (decision_yes + decision_no == 0 ) ?
-			0 : (double)decision_yes / (decision_yes + decision_no) ; 
+	double decision_ratio = (yes + no == 0 ) ?
+			0 : (double)yes / (yes + no) ; 
     recordScalar (name, decision_ratio);
 
 	decisor->finish(getIndex(), this);
@@ -350,9 +355,11 @@ bool base_cache::fake_lookup(chunk_t chunk)
  */
 void base_cache::clear_stat()
 {
-    hit = miss = 0;
+    hit.clear();
+    miss.clear();
 
-	decision_yes = decision_no = 0;
+	decision_yes.clear();
+	decision_no.clear();
 
 	//**mt** DISABLED
     //delete [] cache_stats;
@@ -370,24 +377,24 @@ void base_cache::set_size(uint32_t cSize)
 	cache_size = cSize;
 }
 
-uint32_t base_cache::get_decision_yes()
+uint64_t base_cache::get_decision_yes()
 {
-	return decision_yes;	
+	return decision_yes.value();
 }
 
-uint32_t base_cache::get_decision_no()
+uint64_t base_cache::get_decision_no()
 {
-	return decision_no;
+	return decision_no.value();
 }
 
-void base_cache::set_decision_yes(uint32_t n)
+void base_cache::set_decision_yes(uint64_t n)
 {
-	decision_yes = n;
+	decision_yes.set(n);
 }
 
-void base_cache::set_decision_no(uint32_t n)
+void base_cache::set_decision_no(uint64_t n)
 {
-	decision_no = n;
+	decision_no.set(n);
 }
 
 DecisionPolicy* base_cache::get_decisor() const
@@ -411,7 +418,7 @@ void base_cache::read_tc_value()
 	fin_tc.open(TC_PATH);
 	if(!fin_tc)
 	{
-		std::cout << "\n TC File does NOT exist!\n";
+		DIAG(DIAG_WARN, diag_out) << "\n TC File does NOT exist!\n";
 	   	fin_tc.close();
 	   	exit(0);
 	}
@@ -436,7 +443,7 @@ void base_cache::read_tc_value()
 		}
 		fin_tc.close();
 
-		cout << "NODE # " << getIndex() << " has TC = " << tc_node << " s" << endl;
+		DIAG(DIAG_DEBUG, diag_out) << "NODE # " << getIndex() << " has TC = " << tc_node << " s" << endl;
 	}
 }
 
@@ -451,7 +458,7 @@ void base_cache::read_tc_name_value()
 	fin_tc.open(TC_NAME_PATH);
 	if(!fin_tc)
 	{
-		std::cout << "\n TC NAME File does NOT exist!\n";
+		DIAG(DIAG_WARN, diag_out) << "\n TC NAME File does NOT exist!\n";
 	   	fin_tc.close();
 	   	exit(0);
 	}
@@ -476,6 +483,6 @@ void base_cache::read_tc_name_value()
 		}
 		fin_tc.close();
 
-		cout << "NODE # " << getIndex() << " has TC NAME = " << tc_name_node << " s" << endl;
+		DIAG(DIAG_DEBUG, diag_out) << "NODE # " << getIndex() << " has TC NAME = " << tc_name_node << " s" << endl;
 	}
 }
@@ -32,6 +32,7 @@
 #include <iostream>
 
 #include "error_handling.h"
+#include "diag_log.h"
 
 
 Register_Class(fifo_cache);
@@ -141,7 +142,7 @@ void fifo_cache::finish()
 	cache.clear();
 
 	base_cache::finish();
-	cout << "NODE # " << getParentModule()->getIndex() << " Evaluated Tc: " << (double)(nodeTc/tcSamples) << endl;
+	DIAG(DIAG_DEBUG, diag_out) << "NODE # " << getParentModule()->getIndex() << " Evaluated Tc: " << (double)(nodeTc/tcSamples) << endl;
 }
 
 bool fifo_cache::fake_lookup(chunk_t elem){
@@ -34,6 +34,7 @@
 #include "two_lru_policy.h"
 
 #include "error_handling.h"
+#include "diag_log.h"
 
 Register_Class(lru_cache);
 
@@ -49,7 +50,7 @@ void lru_cache::finish()
 		if(twoLruDecisor)
 		{
 			double tcNameCache = (double)(twoLruDecisor->name_cache->nodeTc/twoLruDecisor->name_cache->tcSamples);
-			cout << "NODE # " << getParentModule()->getIndex() << " NAME CACHE Tc: " << tcNameCache << endl;
+			DIAG(DIAG_DEBUG, diag_out) << "NODE # " << getParentModule()->getIndex() << " NAME CACHE Tc: " << tcNameCache << endl;
 		}
 	}*/
 
@@ -66,7 +67,7 @@ void lru_cache::finish()
 				if(twoLruDecisor)
 				{
 					double tcNameCache = (double)((twoLruDecisor->tc_name_cache)/(twoLruDecisor->tc_name_samples));
-					cout << "NODE # " << getParentModule()->getIndex() << " NAME CACHE LRU Tc: " << tcNameCache << endl;
+					DIAG(DIAG_DEBUG, diag_out) << "NODE # " << getParentModule()->getIndex() << " NAME CACHE LRU Tc: " << tcNameCache << endl;
 				}
 
 		    }
@@ -79,7 +80,7 @@ void lru_cache::finish()
 		}
 
 	base_cache::finish();
-	cout << "NODE # " << getParentModule()->getIndex() << " Evaluated Tc: " << (double)(nodeTc/tcSamples) << endl;
+	DIAG(DIAG_DEBUG, diag_out) << "NODE # " << getParentModule()->getIndex() << " Evaluated Tc: " << (double)(nodeTc/tcSamples) << endl;
 }
 
 double lru_cache::get_tc_node()
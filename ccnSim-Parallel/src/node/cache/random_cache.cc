@@ -29,6 +29,7 @@
  *
  */
 #include "random_cache.h"
+#include "diag_log.h"
 Register_Class (random_cache);
 
 
@@ -69,7 +70,7 @@ bool random_cache::warmup(){
     int k = getIndex();
     std::uint64_t chunk=0;
 
-    cout<<"Starting warmup..."<<endl;
+    DIAG(DIAG_INFO, diag_out) << "Starting warmup..."<<endl;
     for (int i = k*C+1; i<=(k+1)*C; i++){
 	__sid(chunk,i);
 	cache[chunk] = true;
@@ -100,7 +101,7 @@ bool random_cache::warmup(){
     //if (i>F)
     //    return false;
 
-    cout<<"[OK] Cache full"<<endl;
+    DIAG(DIAG_INFO, diag_out) << "[OK] Cache full"<<endl;
     return true;
 
 
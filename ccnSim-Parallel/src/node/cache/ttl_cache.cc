@@ -35,12 +35,13 @@
 #include "statistics.h"
 
 #include "error_handling.h"
+#include "diag_log.h"
 
 Register_Class(ttl_cache);
 
 void ttl_cache::initialize()
 {
-	cout << "-- INITIALIZATION TTL CACHE --" << endl;
+	DIAG(DIAG_DEBUG, diag_out) << "-- INITIALIZATION TTL CACHE --" << endl;
 
 	base_cache::initialize();
 
@@ -56,7 +57,7 @@ void ttl_cache::initialize()
     ASSERT2(down <= (cache_size/10), "Downscaling factor too high! The maximum value, in order to avoid measurement instability on the target cache (and consequent convergence problems), should be 'Cache_DIM/10'\n");
 
     target_cache = cache_size * (1./down);
-    cout << "*** TARGET CACHE: " << target_cache << endl;
+    DIAG(DIAG_DEBUG, diag_out) << "*** TARGET CACHE: " << target_cache << endl;
     avg_as_prev = 0.0;
     time_extend = SIMTIME_DBL(simTime());
     cycle_avg_meas_time = SIMTIME_DBL(simTime()) - time_extend;
@@ -38,11 +38,13 @@
 #include "ccn_data.h"
 #include "base_cache.h"
 #include "statistics.h"
+#include "network_graph.h"
 
 #include "two_lru_policy.h"
 #include "two_ttl_policy.h"
 
 #include "error_handling.h"
+#include "diag_log.h"
 
 Register_Class(core_layer);
 int core_layer::repo_interest = 0;
@@ -56,9 +58,20 @@ void  core_layer::initialize()
 	interest_aggregation = par("interest_aggregation");
 	transparent_to_hops = par("transparent_to_hops");
 
-	repo_load = 0;
+	repo_load.clear();
     nodes = getAncestorPar("n");
     my_btw = getAncestorPar("betweenness");
+
+    // The btw decision policy needs the betweenness centrality of every node. If it
+    // has not been given in the NED/ini files, it is computed here (once for the
+    // whole network) and written back to the node, where the content store reads it.
+    string decision_policy = getParentModule()->getSubmodule("content_store")->par("DS").stdstringValue();
+    if (my_btw < 0 && decision_policy.find("btw") == 0)
+    {
+    	network_graph *graph = network_graph::get(getParentModule()->getParentModule());
+    	my_btw = graph->get_betweenness(par("btw_threads"))[getIndex()];
+    	getParentModule()->par("betweenness").setDoubleValue(my_btw);
+    }
     int num_repos = getAncestorPar("num_repos");
 
 	#ifdef SEVERE_DEBUG
@@ -67,7 +80,7 @@ void  core_layer::initialize()
 	#endif
 
     int i = 0;
-    my_bitmask = 0;
+    my_repo = -1;
     for (i = 0; i < num_repos; i++)
 	{
 		if (content_distribution::repositories[i] == getIndex() )
@@ -76,12 +89,12 @@ void  core_layer::initialize()
 				it_has_a_repo_attached = true;
 			#endif
 
-			repo_price = content_distribution::repo_prices[i]; 
+			repo_price = content_distribution::repo_prices[i];
+			my_repo = i;
 			break;
 		} else
 			repo_price = 0;
 	}
-    my_bitmask = (1<<i);	// Recall that the width of the repository bitset is only num_repos.
 
     // Initialize pointers to Content Store and Strategy Layer.
     ContentStore = (base_cache *) gate("cache_port$o")->getNextGate()->getOwner();
@@ -250,16 +263,16 @@ void core_layer::finish()
     char name [30];
 
     sprintf ( name, "interests[%d]", getIndex());	// Total number of received Interest packets.
-    recordScalar (name, interests);
+    recordScalar (name, interests.value());
 
-    if (repo_load != 0)
+    if (repo_load.value() != 0)
     {
 		sprintf ( name, "repo_load[%d]", getIndex());
-		recordScalar(name,repo_load);
+		recordScalar(name,repo_load.value());
     }
 
     sprintf ( name, "data[%d]", getIndex());	//	Total number of received Data packets.
-    recordScalar (name, data);
+    recordScalar (name, data.value());
 
     if (repo_interest != 0)
     {
@@ -369,7 +382,7 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
 							if(nextNode == 1)
 							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T1 - 1" << "\tContent # " << __id(chunk)-1 << endl;
+								DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\t LL-T1 - 1" << "\tContent # " << __id(chunk)-1 << endl;
 							}
 						}
 						else if(getIndex() == 1)
@@ -377,7 +390,7 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
 							if(nextNode == 3)
 							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T2 - 1" << "\tContent # " << __id(chunk)-1 << endl;
+								DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\t LL-T2 - 1" << "\tContent # " << __id(chunk)-1 << endl;
 							}
 						}
 						else if(getIndex() == 3)
@@ -385,7 +398,7 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
 							if(nextNode == 7)
 							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T3 - 1" << "\tContent # " << __id(chunk)-1 << endl;
+								DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\t LL-T3 - 1" << "\tContent # " << __id(chunk)-1 << endl;
 							}
 						}
 						// With percentiles
@@ -407,7 +420,7 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 		check_if_correct(__LINE__);
         #endif
     }
-    else if ( my_bitmask & __repo(int_msg->get_name()))  // b) Lookup inside the attached repo if I am supposed
+    else if ( content_distribution::stores(__repo(int_msg->get_name()), my_repo))  // b) Lookup inside the attached repo if I am supposed
     													 //	   to be the source for the requested content.
     {
     	// *** Logging MISS EVENT with timestamp
@@ -476,7 +489,7 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
 							if(nextNode == 1)
 							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T1 - 1" << "\tContent # " << __id(chunk)-1 << endl;
+								DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\t LL-T1 - 1" << "\tContent # " << __id(chunk)-1 << endl;
 							}
 						}
 						else if(getIndex() == 1)
@@ -484,7 +497,7 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
 							if(nextNode == 3)
 							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T2 - 1" << "\tContent # " << __id(chunk)-1 << endl;
+								DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\t LL-T2 - 1" << "\tContent # " << __id(chunk)-1 << endl;
 							}
 						}
 						else if(getIndex() == 3)
@@ -492,7 +505,7 @@ void core_layer::handle_interest(ccn_interest *int_msg)
 							double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
 							if(nextNode == 7)
 							{
-								cout << SIMTIME_DBL(simTime()) << "\t LL-T3 - 1" << "\tContent # " << __id(chunk)-1 << endl;
+								DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\t LL-T3 - 1" << "\tContent # " << __id(chunk)-1 << endl;
 							}
 						}
 
@@ -657,7 +670,7 @@ void core_layer::handle_data(ccn_data *data_msg)
 									double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
 									if(nextNode == 1)
 									{
-										cout << SIMTIME_DBL(simTime()) << "\t LL-T1 - 1" << "\tContent # " << __id(chunk)-1 << endl;
+										DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\t LL-T1 - 1" << "\tContent # " << __id(chunk)-1 << endl;
 									}
 								}
 								else if(getIndex() == 1)
@@ -665,7 +678,7 @@ void core_layer::handle_data(ccn_data *data_msg)
 									double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
 									if(nextNode == 3)
 									{
-										cout << SIMTIME_DBL(simTime()) << "\t LL-T2 - 1" << "\tContent # " << __id(chunk)-1 << endl;
+										DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\t LL-T2 - 1" << "\tContent # " << __id(chunk)-1 << endl;
 									}
 								}
 								else if(getIndex() == 3)
@@ -673,7 +686,7 @@ void core_layer::handle_data(ccn_data *data_msg)
 									double nextNode = getParentModule()->gate("face$o",outIndex+1)->getNextGate()->getOwnerModule()->getIndex();
 									if(nextNode == 7)
 									{
-										cout << SIMTIME_DBL(simTime()) << "\t LL-T3 - 1" << "\tContent # " << __id(chunk)-1 << endl;
+										DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\t LL-T3 - 1" << "\tContent # " << __id(chunk)-1 << endl;
 									}
 								}
 
@@ -806,10 +819,10 @@ ccn_data* core_layer::compose_data(std::uint64_t response_data){
  */
 void core_layer::clear_stat(){
     repo_interest = 0;
-    interests = 0;
-    data = 0;
+    interests.clear();
+    data.clear();
     
-    repo_load = 0;
+    repo_load.clear();
 	ContentStore->set_decision_yes(0);
 	ContentStore->set_decision_no(0);
 
@@ -826,36 +839,36 @@ void core_layer::clear_stat(){
 #ifdef SEVERE_DEBUG
 void core_layer::check_if_correct(int line)
 {
-	if (repo_load != interests - discarded_interests - unsatisfied_interests
+	if (repo_load.value() != interests.value() - discarded_interests - unsatisfied_interests
 		-interests_satisfied_by_cache)
 	{
 			std::stringstream msg; 
 			msg<<"node["<<getIndex()<<"]: "<<
-				"repo_load="<<repo_load<<"; interests="<<interests<<
+				"repo_load="<<repo_load.value()<<"; interests="<<interests.value()<<
 				"; discarded_interests="<<discarded_interests<<
 				"; unsatisfied_interests="<<unsatisfied_interests<<
 				"; interests_satisfied_by_cache="<<interests_satisfied_by_cache;
 		    severe_error(__FILE__, line, msg.str().c_str() );
 	}
 
-	if (!it_has_a_repo_attached && repo_load>0 )
+	if (!it_has_a_repo_attached && repo_load.value()>0 )
 	{
 			std::stringstream msg; 
 			msg<<"node["<<getIndex()<<"] has no repo attached. "<<
-				"repo_load=="<<repo_load<<
+				"repo_load=="<<repo_load.value()<<
 				"; repo_interest=="<<repo_interest;
 			severe_error(__FILE__, line, msg.str().c_str() );
 	}
 
 	if (	ContentStore->get_decision_yes() + ContentStore->get_decision_no() +  
 						(unsigned) unsolicited_data
-						!=  (unsigned) data + repo_load
+						!=  data.value() + repo_load.value()
 	){
 					std::stringstream ermsg; 
 					ermsg<<"caches["<<getIndex()<<"]->decision_yes="<<ContentStore->get_decision_yes()<<
 						"; caches[i]->decision_no="<< ContentStore->get_decision_no()<<
-						"; cores[i]->data="<< data<<
-						"; cores[i]->repo_load="<< repo_load<<
+						"; cores[i]->data="<< data.value()<<
+						"; cores[i]->repo_load="<< repo_load.value()<<
 						"; cores[i]->unsolicited_data="<< unsolicited_data<<
 						". The sum of "<< "decision_yes + decision_no + unsolicited_data must be data";
 					severe_error(__FILE__,line,ermsg.str().c_str() );
@@ -1013,9 +1026,9 @@ void core_layer::evaluateLinkLoad()
 				currentChLoad = currentBitPerSec/datarate;       // So far the datarate is fixed and equal for each link.
 				nextNode = getParentModule()->gate("face$o",i+1)->getNextGate()->getOwnerModule()->getIndex();
 				if(numBits[i] != 0 )
-					cout << SIMTIME_DBL(simTime()) << "\tAvg LL Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " = " << currentChLoad << endl;
+					DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\tAvg LL Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " = " << currentChLoad << endl;
 				else
-					cout << SIMTIME_DBL(simTime()) << "\tAvg LL Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " = 0" << endl;
+					DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\tAvg LL Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " = 0" << endl;
 		}
 	}
 	else
@@ -1039,7 +1052,7 @@ void core_layer::evaluateLinkLoad()
 				currentBitPerSec = intvlNumBits[i]/maxInterval;
 				currentChLoad = currentBitPerSec/datarate;       // So far the datarate is fixed and equal for each link.
 				nextNode = getParentModule()->gate("face$o",i+1)->getNextGate()->getOwnerModule()->getIndex();
-				cout << SIMTIME_DBL(simTime()) << "\tLink Load Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " = " << currentChLoad << endl;
+				DIAG(DIAG_INFO, diag_out) << SIMTIME_DBL(simTime()) << "\tLink Load Nodes\t" << getIndex() << " OUT \t-->\t" << nextNode << " = " << currentChLoad << endl;
 				intvlNumBits[i] = 0;
 				intvlNumPackets[i] = 0;
 
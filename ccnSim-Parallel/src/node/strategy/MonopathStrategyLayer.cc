@@ -40,7 +40,7 @@
 const int_f MonopathStrategyLayer::get_FIB_entry(
 		int destination_node_index)
 {
-	const vector<int_f> FIB_entries = get_FIB_entries(destination_node_index);
+	const vector<int_f> &FIB_entries = get_FIB_entries(destination_node_index);
 	#ifdef SEVERE_DEBUG
 	int output_gates = getParentModule()->gateSize("face$o");
 	std::stringstream msg;
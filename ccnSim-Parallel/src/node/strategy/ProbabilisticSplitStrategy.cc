@@ -169,7 +169,7 @@ bool* ProbabilisticSplitStrategy::exploit(ccn_interest *interest)
     bool *decision = new bool[gsize];
 	std::fill(decision,decision+gsize,0);
     	
-	const vector<int_f> FIB_entries = get_FIB_entries(repository);
+	const vector<int_f> &FIB_entries = get_FIB_entries(repository);
 	int out_gate = decide_out_gate(FIB_entries);
 	decision[out_gate]=true;
     return decision;
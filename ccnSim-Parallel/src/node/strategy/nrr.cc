@@ -347,18 +347,9 @@ bool *nrr::exploit_model(long content){
 	vector<Centry>::iterator it = std::find_if (cfib.begin(),cfib.end(),lookup(m) );
 
 	// Find the original repo of the content
-	repo_t repo = __repo(m+1);
-	int l = 0;
-	int repo_ID;
-	while (repo)
-	{
-		if (repo & 1)
-		{
-			repo_ID = content_distribution::repositories[l];
-		}
-		repo >>= 1;
-		l++;
-	}
+	vector<int> repos;
+	content_distribution::repo_nodes(m+1, repos);
+	int repo_ID = repos.back();
 
 	const int_f FIB_entry = get_FIB_entry(repo_ID);
 
@@ -0,0 +1,120 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "routing_service.h"
+#include "network_graph.h"
+#include "content_distribution.h"
+#include "error_handling.h"
+#include <sstream>
+
+routing_service *routing_service::instance = NULL;
+
+#define UNREACHABLE 0xFFFF
+
+
+routing_service *routing_service::get(cModule *network, const string &destinations)
+{
+	if (!instance)
+		instance = new routing_service(network, destinations);
+	return instance;
+}
+
+void routing_service::release()
+{
+	delete instance;
+	instance = NULL;
+}
+
+routing_service::routing_service(cModule *network, const string &dest_type)
+{
+	graph = network_graph::get(network);
+	int num_nodes = graph->get_num_nodes();
+
+	if (dest_type == "all"){
+		for (int v = 0; v < num_nodes; v++)
+			destinations.push_back(v);
+	} else if (dest_type == "repos"){
+		for (int r = 0; r < content_distribution::num_repos; r++)
+			destinations.push_back(content_distribution::repositories[r]);
+	} else{
+		std::stringstream ermsg;
+		ermsg<<"Unknown routing destinations "<<dest_type<<". Valid values are all, repos";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	dest_slot.assign(num_nodes, -1);
+	dist.resize(destinations.size());
+	for (unsigned slot = 0; slot < destinations.size(); slot++){
+		dest_slot[destinations[slot]] = slot;
+		bfs(destinations[slot], dist[slot]);
+	}
+
+	cout<<"Routing service: "<<num_nodes<<" nodes, "<<graph->get_num_links()<<" links, "
+		<<destinations.size()<<" destinations"<<endl;
+}
+
+// Hop distance of every node from 'dest' (links are bidirectional).
+void routing_service::bfs(int dest, vector<unsigned short> &d) const
+{
+	d.assign(graph->get_num_nodes(), UNREACHABLE);
+	vector<int> queue;
+	queue.reserve(graph->get_num_nodes());
+	d[dest] = 0;
+	queue.push_back(dest);
+	for (unsigned head = 0; head < queue.size(); head++){
+		int v = queue[head];
+		for (int a = graph->first(v); a < graph->last(v); a++){
+			int w = graph->neighbor(a);
+			if (d[w] == UNREACHABLE){
+				d[w] = d[v] + 1;
+				queue.push_back(w);
+			}
+		}
+	}
+}
+
+int routing_service::next_hops(int node, int dest, vector<int> &faces) const
+{
+	faces.clear();
+	int slot = dest_slot[dest];
+	if (slot < 0){
+		std::stringstream ermsg;
+		ermsg<<"Node "<<dest<<" is not a destination of the routing service";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	const vector<unsigned short> &d = dist[slot];
+	if (d[node] == UNREACHABLE)
+		return -1;
+
+	for (int a = graph->first(node); a < graph->last(node); a++)
+		if (d[graph->neighbor(a)] + 1 == d[node])
+			faces.push_back(graph->face(a));
+	return d[node];
+}
@@ -34,6 +34,7 @@
 #include "ccn_interest.h"
 #include "error_handling.h"
 #include <sstream>
+#include <climits>
 
 
 Register_Class(spr);
@@ -85,7 +86,7 @@ int spr::nearest(vector<int>& repositories){
 		severe_error(__FILE__,__LINE__, "repositories has 0 elements");
 	#endif
 	
-    int  min_len = 10000;
+    int  min_len = INT_MAX;
     vector<int> targets;
 
     for (vector<int>::iterator i = repositories.begin(); i!=repositories.end();i++) 	{ 	//Find the shortest (the minimum)
@@ -33,6 +33,8 @@
 #include "error_handling.h"
 #include "content_distribution.h"
 #include "statistics.h"
+#include "routing_service.h"
+#include "network_graph.h"
 ifstream strategy_layer::fdist;
 ifstream strategy_layer::frouting;
 
@@ -95,6 +97,12 @@ void strategy_layer::initialize()
     string fileradix = par("routing_file").stringValue();
     string filerout = fileradix+".rou";
     string filedist = fileradix+".dist";
+    if (par("routing_destinations").stdstringValue() != "all" && (fileradix != "" || par("routing").stdstringValue() != "bfs"))
+    {
+    	std::stringstream ermsg;
+    	ermsg<<"routing_destinations = \""<<par("routing_destinations").stdstringValue()<<"\" needs routing = \"bfs\" (and no routing_file)";
+    	severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+    }
     if (fileradix!= "")
     {
     	if (!fdist.is_open())
@@ -104,6 +112,10 @@ void strategy_layer::initialize()
     	}
     	populate_from_file(); 	// Building forwarding table.
 	}
+    else if (par("routing").stdstringValue() == "bfs")
+    {
+    	populate_from_routing_service(); // Building forwarding table.
+    }
     else
     {
     	populate_routing_table(); // Building forwarding table.
@@ -123,6 +135,8 @@ void strategy_layer::finish()
 {
     fdist.close();
     frouting.close();
+    routing_service::release();
+    network_graph::release();
     delete failure;
     delete recovery;
     delete new_routes;
@@ -256,6 +270,50 @@ void strategy_layer::populate_routing_table()
     }
 }
 
+// Populate the routing table from the shortest paths computed once for the whole
+// network by the routing service (faster than populate_routing_table() on large topologies).
+void strategy_layer::populate_from_routing_service()
+{
+	// Only the strategies that forward towards the repositories can do without
+	// the FIB entries towards the other nodes (nrr and nrr1 explore them all).
+	string destinations_type = par("routing_destinations").stdstringValue();
+	string forwStr = getParentModule()->par("FS");
+	if (destinations_type == "repos" && forwStr != "spr" && forwStr != "random_repository"
+			&& forwStr != "parallel_repository" && forwStr != "ProbabilisticSplitStrategy")
+	{
+		std::stringstream ermsg;
+		ermsg<<"routing_destinations = \"repos\" cannot be used with the forwarding strategy "<<forwStr
+			<<" (only spr, random_repository, parallel_repository, ProbabilisticSplitStrategy)";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+
+	routing_service *service = routing_service::get(getParentModule()->getParentModule(), destinations_type);
+	int me = getParentModule()->getIndex();
+	vector<int> faces;
+
+	const vector<int> &destinations = service->get_destinations();
+	for (unsigned k = 0; k < destinations.size(); k++)
+	{
+		int dest = destinations[k];
+		if (dest == me)
+			continue;
+
+		int distance = service->next_hops(me, dest, faces);
+		if (faces.empty())
+		{
+			cout << "strategy_layer.cc:"<<__LINE__<<": ERROR: No paths connecting"
+				<<" node "<< me <<" to node "<< dest <<
+				" have been found"<<endl;
+			exit(-5);
+		}
+
+		// Choose the paths towards the target according to the chosen forwarding strategy.
+		vector<int> paths = choose_paths(faces.size());
+		for (unsigned int i=0; i<paths.size(); i++)
+			add_FIB_entry(dest, faces[paths[i]], distance);
+	}
+}
+
 void strategy_layer::populate_from_file()
 {
     string rline, dline;
@@ -302,11 +360,10 @@ void strategy_layer::add_FIB_entry(int destination_node_index, int interface_ind
 	#endif
 }
 
-const vector<int_f> strategy_layer::get_FIB_entries(
+const vector<int_f> &strategy_layer::get_FIB_entries(
 		int destination_node_index)
 {
-	vector<int_f> entries = FIB[destination_node_index] ;
-	return entries;
+	return FIB[destination_node_index];
 }
 
 int strategy_layer::get_out_interface(int destination_node)
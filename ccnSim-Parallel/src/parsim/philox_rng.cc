@@ -0,0 +1,263 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "philox_rng.h"
+#include "error_handling.h"
+#include <algorithm>
+#include <cstring>
+
+Register_Class(philox_rng);
+
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+#define ENGINE_STREAM 0x80000000U		// Stream numbers of the engine RNGs.
+
+bool philox_rng::active = false;
+int philox_rng::seed_set = 0;
+int philox_rng::engine = 0;
+vector<philox_rng*> philox_rng::streams;
+vector<philox_rng*> philox_rng::engine_rngs;
+
+// Finalizer of splitmix64, used to spread the fields of the keys.
+static inline uint64_t mix64(uint64_t z)
+{
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+// FNV-1a, to turn the full path of a component into its stream identifier.
+static inline uint64_t path_hash(const string &path)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < path.size(); i++)
+		h = (h ^ (unsigned char)path[i]) * 0x100000001b3ULL;
+	return h;
+}
+
+
+philox_rng::philox_rng()
+{
+	set_key(0, 0, 0);
+}
+
+philox_rng::philox_rng(int seed_set, uint64_t id, uint32_t stream)
+{
+	set_key(seed_set, id, stream);
+}
+
+philox_rng::~philox_rng()
+{
+	engine_rngs.erase(remove(engine_rngs.begin(), engine_rngs.end(), this), engine_rngs.end());
+}
+
+void philox_rng::set_key(int seed_set, uint64_t stream_id, uint32_t stream_num)
+{
+	uint64_t k = mix64(((uint64_t)(uint32_t)seed_set << 32) | stream_num);
+	if (engine != 0)
+		k = mix64(k + (uint32_t)engine);
+	key[0] = (uint32_t)k;
+	key[1] = (uint32_t)(k >> 32);
+	id = stream_id;
+	stream = stream_num;
+	seed = seed_set;
+	position = 0;
+	next = 4*PHILOX_BATCH;
+	drawn = 0;
+}
+
+/*
+ * Called by the simulation kernel for each global RNG of the run. The first
+ * one also resets the component streams of the previous run.
+ */
+void philox_rng::initialize(int seedSet, int rngId, int numRngs, int parsimProcId,
+		int parsimNumPartitions, cConfiguration *cfg)
+{
+	if (rngId == 0)
+	{
+		for (unsigned i = 0; i < streams.size(); i++)
+			delete streams[i];
+		streams.clear();
+		engine = 0;
+	}
+	active = true;
+	seed_set = seedSet;
+	set_key(seedSet, ((uint64_t)parsimProcId << 32) | (uint32_t)rngId, ENGINE_STREAM);
+	if (find(engine_rngs.begin(), engine_rngs.end(), this) == engine_rngs.end())
+		engine_rngs.push_back(this);
+}
+
+/*
+ * The streams restart from their beginning, under the key of the new engine.
+ */
+bool philox_rng::set_engine(int e)
+{
+	if (!active)
+		return false;
+	engine = e;
+	for (unsigned i = 0; i < engine_rngs.size(); i++)
+		engine_rngs[i]->set_key(engine_rngs[i]->seed, engine_rngs[i]->id, engine_rngs[i]->stream);
+	for (unsigned i = 0; i < streams.size(); i++)
+		if (streams[i])
+			streams[i]->set_key(streams[i]->seed, streams[i]->id, streams[i]->stream);
+	return true;
+}
+
+void philox_rng::block(uint32_t ctr[4], const uint32_t k[2])
+{
+	uint32_t k0 = k[0], k1 = k[1];
+	for (int r = 0; r < PHILOX_ROUNDS; r++)
+	{
+		uint64_t p0 = (uint64_t)PHILOX_M0 * ctr[0];
+		uint64_t p1 = (uint64_t)PHILOX_M1 * ctr[2];
+		uint32_t c1 = ctr[1], c3 = ctr[3];
+		ctr[0] = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+		ctr[1] = (uint32_t)p1;
+		ctr[2] = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+		ctr[3] = (uint32_t)p0;
+		k0 += PHILOX_W0;
+		k1 += PHILOX_W1;
+	}
+}
+
+/*
+ * Generates the next PHILOX_BATCH blocks. The blocks are independent, so the
+ * loop is left to the auto-vectorizer.
+ */
+void philox_rng::refill()
+{
+	for (unsigned b = 0; b < PHILOX_BATCH; b++)
+	{
+		uint32_t *ctr = buffer + 4*b;
+		ctr[0] = (uint32_t)(position + b);
+		ctr[1] = (uint32_t)((position + b) >> 32);
+		ctr[2] = (uint32_t)id;
+		ctr[3] = (uint32_t)(id >> 32);
+		block(ctr, key);
+	}
+	position += PHILOX_BATCH;
+	next = 0;
+}
+
+rng_word_t philox_rng::intRand()
+{
+	if (next == 4*PHILOX_BATCH)
+		refill();
+	drawn++;
+	return buffer[next++];
+}
+
+/*
+ * Uniform integer in [0, n-1], without modulo bias (Lemire's multiply and
+ * reject).
+ */
+rng_word_t philox_rng::intRand(rng_word_t n)
+{
+	if (n == 0 || n > 0xffffffffUL)
+	{
+		std::stringstream ermsg;
+		ermsg<<"philox_rng: intRand("<<n<<") out of range";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+	uint64_t m = (uint64_t)(uint32_t)intRand() * n;
+	if ((uint32_t)m < n)
+	{
+		uint32_t threshold = (uint32_t)(-(uint32_t)n) % (uint32_t)n;
+		while ((uint32_t)m < threshold)
+			m = (uint64_t)(uint32_t)intRand() * n;
+	}
+	return (rng_word_t)(m >> 32);
+}
+
+// 53-bit uniforms, made of two words.
+double philox_rng::doubleRand()
+{
+	uint64_t a = intRand() >> 5, b = intRand() >> 6;
+	return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+}
+
+double philox_rng::doubleRandNonz()
+{
+	double d;
+	do
+		d = doubleRand();
+	while (d == 0);
+	return d;
+}
+
+double philox_rng::doubleRandIncl1()
+{
+	uint64_t a = intRand() >> 5, b = intRand() >> 6;
+	return (a * 67108864.0 + b) * (1.0 / 9007199254740991.0);
+}
+
+/*
+ * Known answer tests of the Random123 distribution.
+ */
+void philox_rng::selfTest()
+{
+	static const uint32_t kat[3][10] = {
+		{0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+			0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+		{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+			0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+		{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0,
+			0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+
+	for (int t = 0; t < 3; t++)
+	{
+		uint32_t ctr[4];
+		memcpy(ctr, kat[t], sizeof(ctr));
+		block(ctr, kat[t] + 4);
+		if (memcmp(ctr, kat[t] + 6, sizeof(ctr)) != 0)
+		{
+			std::stringstream ermsg;
+			ermsg<<"philox_rng: self test "<<t<<" failed";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+		}
+	}
+}
+
+cRNG *philox_rng::module_stream(cComponent *c)
+{
+	if (!active)
+		return c->getRNG(0);
+
+	unsigned i = c->getId();
+	if (i >= streams.size())
+		streams.resize(i + 1, NULL);
+	if (!streams[i])
+		streams[i] = new philox_rng(seed_set, path_hash(c->getFullPath()));
+	return streams[i];
+}
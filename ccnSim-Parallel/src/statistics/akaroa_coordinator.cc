@@ -0,0 +1,151 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "akaroa_coordinator.h"
+#include "error_handling.h"
+#include <signal.h>
+#include <algorithm>
+#include <sstream>
+#include <unistd.h>
+
+#ifdef WITH_AKAROA
+#include <akaroa.H>
+#include <akaroa/ak_message.H>
+#endif
+
+#define AK_CONTINUE 30
+#define AK_STOP 31
+
+akaroa_coordinator::akaroa_coordinator()
+{
+	engines = 1;
+	num_nodes = 0;
+	window = 0;
+	partial_n = 0;
+	share_left = 0;
+}
+
+double akaroa_coordinator::claim(double chunk)
+{
+	double granted = std::min(chunk, share_left);
+	share_left -= granted;
+	return granted;
+}
+
+#ifdef WITH_AKAROA
+
+int akaroa_coordinator::start(int num_engines, int nodes, int node_window, int partial)
+{
+	engines = num_engines;
+	num_nodes = nodes;
+	window = node_window;
+	partial_n = partial;
+	share_left = budget / engines;
+
+	int numParam = 2;			// We consider the HitMiss vector for the stability, and the measured cache size at the end.
+	AkDeclareParameters(numParam);  // Declare the number of parameters
+
+	char *msg6 = (char *)"Parameters declared:  %i";
+	AkMessage(msg6, numParam);
+
+	// The verdicts of the master are collected by wait_verdict(); the other
+	// threads of the engine (e.g., the diag_log writer) block all the signals.
+	sigset_t set;
+	sigemptyset(&set);
+	sigaddset(&set, AK_CONTINUE);
+	sigaddset(&set, AK_STOP);
+	if (pthread_sigmask(SIG_BLOCK, &set, NULL) != 0)
+	{
+		char *msg8 = (char *)"\ncan't block the signals of the master\n";
+		AkMessage(msg8);
+	}
+	return 0;
+}
+
+bool akaroa_coordinator::wait_verdict()
+{
+	sigset_t set;
+	sigemptyset(&set);
+	sigaddset(&set, AK_CONTINUE);
+	sigaddset(&set, AK_STOP);
+	int signo = 0;
+	while (sigwait(&set, &signo) != 0)
+		;
+	return signo == AK_STOP;
+}
+
+/*
+ *   AkObservationMGvect(paramNum, HitMiss, num_nodes, engineWindow, partial_n, pid, num_threads)
+ *   - paramNum: 2 for the HitMiss vector, 1 for the measured cache size; it is used by the Master
+ *   			 to differentiate the checkpoint processing.
+ *   - pid: process id of the current engine.
+ *   - num_threads: number of parallel engines which are executing the current simulation.
+ */
+bool akaroa_coordinator::stable(stability_window &windows, double cv_thr)
+{
+	// The master needs the raw windows.
+	hit_miss.resize(2*(size_t)num_nodes*window);
+	windows.hit_miss(&hit_miss[0]);
+	AkObservationMGvect(2, &hit_miss[0], num_nodes, window, partial_n, getpid(), engines);
+	bool stop = wait_verdict();
+	AkMessage(stop ? (char *)"STOP the CENTRALIZED STABLE CHECK!\n" : (char *)"CONTINUE the CENTRALIZED STABLE CHECK!\n");
+	return stop;
+}
+
+bool akaroa_coordinator::consistent(double measured, double target, double cons_thr)
+{
+	AkObservationMG(1, measured, target, num_nodes, window, partial_n, getpid(), engines);
+	bool stop = wait_verdict();
+	share_left = budget / engines;
+	AkMessage(stop ? (char *)"STOP the simulation\n" : (char *)"CONTINUE the simulation with another MC-TTL cycle!\n");
+	return stop;
+}
+
+#else
+
+int akaroa_coordinator::start(int num_engines, int nodes, int node_window, int partial)
+{
+	std::stringstream ermsg;
+	ermsg<<"ccnSim has been built without Akaroa: use **.coordinator = \"local\" or \"socket\"";
+	severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	return 0;
+}
+
+bool akaroa_coordinator::stable(stability_window &windows, double cv_thr)
+{
+	return false;
+}
+
+bool akaroa_coordinator::consistent(double measured, double target, double cons_thr)
+{
+	return false;
+}
+
+#endif
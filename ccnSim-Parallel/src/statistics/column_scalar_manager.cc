@@ -0,0 +1,84 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "column_scalar_manager.h"
+
+Register_Class(column_scalar_manager);
+
+Register_PerRunConfigOption(CFGID_COLUMN_SCALAR_FILE, "column-scalar-file", CFG_FILENAME, "${resultdir}/${configname}-${runnumber}.ccr", "Binary columnar file of the scalars, when outputscalarmanager-class=\"column_scalar_manager\"");
+
+#if OMNETPP_VERSION >= 0x0500
+void column_scalar_manager::lifecycleEvent(SimulationLifecycleEventType event_type, cObject *details)
+{
+	if (event_type == LF_PRE_NETWORK_INITIALIZE)
+		startRun();
+	else if (event_type == LF_ON_RUN_END)
+		endRun();
+}
+#endif
+
+void column_scalar_manager::startRun()
+{
+	results.clear();
+	cConfigurationEx *config = cSimulation::getActiveEnvir()->getConfigEx();
+	run = results.runs.id(config->getVariable(CFGVAR_RUNID));
+	file_name = config->getAsFilename(CFGID_COLUMN_SCALAR_FILE);
+}
+
+void column_scalar_manager::endRun()
+{
+	if (results.size() == 0)
+		return;
+	results.write(file_name.c_str());
+	results.clear();
+}
+
+void column_scalar_manager::recordScalar(cComponent *component, const char *name, double value, opp_string_map *attributes)
+{
+	string metric;
+	int32_t node;
+	split_scalar_name(name, metric, node);
+	results.add(run, results.modules.id(component->getFullPath()), node, results.metrics.id(metric), value);
+}
+
+/*
+ * A statistic is recorded as the scalars "name:count", "name:mean", ...
+ */
+void column_scalar_manager::recordStatistic(cComponent *component, const char *name, cStatistic *statistic, opp_string_map *attributes)
+{
+	if (name == NULL)
+		name = statistic->getFullName();
+	string prefix(name);
+	recordScalar(component, (prefix + ":count").c_str(), statistic->getCount(), NULL);
+	recordScalar(component, (prefix + ":mean").c_str(), statistic->getMean(), NULL);
+	recordScalar(component, (prefix + ":stddev").c_str(), statistic->getStddev(), NULL);
+	recordScalar(component, (prefix + ":min").c_str(), statistic->getMin(), NULL);
+	recordScalar(component, (prefix + ":max").c_str(), statistic->getMax(), NULL);
+}
@@ -0,0 +1,151 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "coordinator.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <unistd.h>
+
+using namespace std;
+
+void stability_master::init(int num_engines, int nodes, int node_window)
+{
+	engines = num_engines;
+	num_nodes = nodes;
+	window = node_window;
+	node_summary empty;
+	empty.count = 0;
+	empty.taken = 0;
+	empty.mean = empty.m2 = 0;
+	state.assign((size_t)engines*num_nodes, empty);
+	for (size_t i = 0; i < state.size(); i++)
+		state[i].node = i % num_nodes;
+}
+
+bool stability_master::update(int engine, const node_summary *records, int count)
+{
+	if (engine < 0 || engine >= engines)
+		return false;
+	for (int k = 0; k < count; k++)
+	{
+		if (records[k].node < 0 || records[k].node >= num_nodes)
+			return false;
+		state[(size_t)engine*num_nodes + records[k].node] = records[k];
+	}
+	return true;
+}
+
+/*
+ * The summaries of the engines are merged with the pairwise update of Chan et
+ * al.; the variance is that of the population of the samples. A node whose
+ * windows are full in every engine but hold no valid sample has had no
+ * traffic: it is stable, but not with traffic.
+ */
+int stability_master::stable_nodes(double cv_thr, int &with_traffic) const
+{
+	int stables = 0;
+	with_traffic = 0;
+	for (int n = 0; n < num_nodes; n++)
+	{
+		double count = 0, mean = 0, m2 = 0;
+		bool full = true;
+		for (int e = 0; e < engines; e++)
+		{
+			const node_summary &s = state[(size_t)e*num_nodes + n];
+			full = full && s.taken >= (uint32_t)window;
+			if (s.count == 0)
+				continue;
+			double total = count + s.count;
+			double delta = s.mean - mean;
+			mean += delta * s.count/total;
+			m2 += s.m2 + delta*delta * count*s.count/total;
+			count = total;
+		}
+		if (full && count == 0)
+		{
+			stables++;
+			continue;
+		}
+		// Otherwise, only the nodes that have a window of valid samples in every engine are evaluated.
+		if (count < (double)engines*window || mean <= 0)
+			continue;
+		double var = max(0.0, m2/count);
+		if (sqrt(var)/mean < cv_thr)
+		{
+			stables++;
+			with_traffic++;
+		}
+	}
+	return stables;
+}
+
+bool master_stable(int stables, int with_traffic, int partial_n)
+{
+	return stables >= partial_n && with_traffic >= partial_n/2;
+}
+
+bool master_consistent(double sum_measured, double sum_target, double cons_thr)
+{
+	return sum_target > 0 && fabs(sum_measured - sum_target)/sum_target < cons_thr;
+}
+
+// Whole-buffer I/O on a stream socket.
+bool write_all(int fd, const void *buf, size_t len)
+{
+	const char *p = (const char *)buf;
+	while (len > 0)
+	{
+		ssize_t n = write(fd, p, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		p += n;
+		len -= n;
+	}
+	return true;
+}
+
+bool read_all(int fd, void *buf, size_t len)
+{
+	char *p = (char *)buf;
+	while (len > 0)
+	{
+		ssize_t n = read(fd, p, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		p += n;
+		len -= n;
+	}
+	return true;
+}
@@ -0,0 +1,292 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "engine_pool.h"
+#include "diag_log.h"
+#include "error_handling.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define POOL_CHECK_MS 100			// Liveness checks while waiting for the other engines.
+
+struct engine_pool::board{
+	atomic<uint32_t> arrived;
+	atomic<uint32_t> generation;
+	atomic<uint32_t> verdict;
+	atomic<uint32_t> stables;
+	atomic<double> budget_left;		// Of the current MC-TTL cycle.
+	char pad[64 - 4*sizeof(uint32_t) - sizeof(double)];
+
+	// Followed by the observations of the engines: the cache sizes, then the
+	// number of changed summaries and the summaries of each engine, then the
+	// final results of each engine.
+	double *measured() {return (double *)(this + 1);}
+	double *target(int engines) {return measured() + engines;}
+	int *changes(int engines) {return (int *)(target(engines) + engines);}
+	node_summary *records(int engines, int num_nodes, int e)
+	{
+		size_t offset = (engines*sizeof(int) + sizeof(node_summary) - 1)/sizeof(node_summary);
+		return (node_summary *)changes(engines) + offset + (size_t)e*num_nodes;
+	}
+	double *results(int engines, int num_nodes, size_t values, int e)
+	{
+		return (double *)records(engines, num_nodes, engines) + (size_t)e*values;
+	}
+};
+
+
+// The futexes are shared among processes (no FUTEX_PRIVATE_FLAG).
+static inline void futex_wait(atomic<uint32_t> *word, uint32_t value, long timeout_ms)
+{
+	struct timespec timeout;
+	timeout.tv_sec = timeout_ms / 1000;
+	timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+	syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, value, &timeout, NULL, 0);
+}
+
+static inline void futex_wake_all(atomic<uint32_t> *word)
+{
+	syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+
+engine_pool::engine_pool()
+{
+	engines = 1;
+	engine = 0;
+	num_nodes = 0;
+	window = 0;
+	partial_n = 0;
+	shared = NULL;
+	shared_size = 0;
+	parent = 0;
+}
+
+engine_pool::~engine_pool()
+{
+	if (shared)
+		munmap(shared, shared_size);
+}
+
+int engine_pool::start(int num_engines, int nodes, int node_window, int partial)
+{
+	if (num_engines < 1)
+	{
+		std::stringstream ermsg;
+		ermsg<<"engine_pool: "<<num_engines<<" engines requested";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+	engines = num_engines;
+	num_nodes = nodes;
+	window = node_window;
+	partial_n = partial;
+	shared_size = sizeof(board) + 2*engines*sizeof(double) + engines*sizeof(int) + sizeof(node_summary)
+			+ (size_t)engines*num_nodes*sizeof(node_summary) + (size_t)engines*result_values*sizeof(double);
+	void *segment = mmap(NULL, shared_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+	if (segment == MAP_FAILED)
+	{
+		std::stringstream ermsg;
+		ermsg<<"engine_pool: cannot map "<<shared_size<<" bytes of shared memory";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+	shared = new (segment) board();
+	shared->arrived = 0;
+	shared->generation = 0;
+	shared->verdict = 0;
+	shared->stables = 0;
+	shared->budget_left = budget;
+	master.init(engines, num_nodes, window);
+
+	// Buffered output would be written once per engine.
+	cout.flush();
+	fflush(NULL);
+
+	parent = getpid();
+	for (int e = 1; e < engines; e++)
+	{
+		pid_t pid = fork();
+		if (pid < 0)
+		{
+			std::stringstream ermsg;
+			ermsg<<"engine_pool: cannot fork engine "<<e;
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+		}
+		if (pid == 0)
+		{
+			prctl(PR_SET_PDEATHSIG, SIGKILL);
+			if (getppid() != parent)
+				_exit(1);
+			children.clear();
+			engine = e;
+			return engine;
+		}
+		children.push_back(pid);
+	}
+	engine = 0;
+	return engine;
+}
+
+/*
+ * Generation barrier among the engines. The waiting engines sleep on the
+ * generation counter and are woken by the last one; every POOL_CHECK_MS
+ * engine 0 checks that no engine has died (which would otherwise block the
+ * others forever).
+ */
+void engine_pool::barrier()
+{
+	uint32_t gen = shared->generation.load();
+	if (shared->arrived.fetch_add(1) + 1 == (uint32_t)engines)
+	{
+		shared->arrived = 0;
+		shared->generation.fetch_add(1);
+		futex_wake_all(&shared->generation);
+		return;
+	}
+	while (shared->generation.load() == gen)
+	{
+		futex_wait(&shared->generation, gen, POOL_CHECK_MS);
+		if (engine == 0 && shared->generation.load() == gen)
+		{
+			// The engines leaving after the last barrier are not reaped here.
+			siginfo_t info;
+			info.si_pid = 0;
+			if (waitid(P_ALL, 0, &info, WEXITED|WNOHANG|WNOWAIT) == 0 && info.si_pid != 0
+					&& shared->generation.load() == gen)
+			{
+				std::stringstream ermsg;
+				ermsg<<"engine_pool: engine with pid "<<info.si_pid<<" terminated while the others were waiting for it";
+				severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+			}
+		}
+	}
+}
+
+bool engine_pool::stable(stability_window &windows, double cv_thr)
+{
+	changes.clear();
+	windows.take_changes(changes);
+	shared->changes(engines)[engine] = changes.size();
+	copy(changes.begin(), changes.end(), shared->records(engines, num_nodes, engine));
+	barrier();
+
+	if (engine == 0)
+	{
+		for (int e = 0; e < engines; e++)
+			master.update(e, shared->records(engines, num_nodes, e), shared->changes(engines)[e]);
+		int with_traffic;
+		shared->stables = master.stable_nodes(cv_thr, with_traffic);
+		shared->verdict = master_stable(shared->stables, with_traffic, partial_n);
+	}
+	barrier();
+	last_stables = shared->stables;
+	return shared->verdict.load() != 0;
+}
+
+bool engine_pool::consistent(double measured, double target, double cons_thr)
+{
+	shared->measured()[engine] = measured;
+	shared->target(engines)[engine] = target;
+	barrier();
+
+	if (engine == 0)
+	{
+		double sum_measured = 0, sum_target = 0;
+		for (int e = 0; e < engines; e++)
+		{
+			sum_measured += shared->measured()[e];
+			sum_target += shared->target(engines)[e];
+		}
+		shared->verdict = master_consistent(sum_measured, sum_target, cons_thr);
+		shared->budget_left = budget;
+	}
+	barrier();
+	return shared->verdict.load() != 0;
+}
+
+double engine_pool::claim(double chunk)
+{
+	double left = shared->budget_left.load();
+	double granted;
+	do
+		granted = min(chunk, left);
+	while (granted > 0 && !shared->budget_left.compare_exchange_weak(left, left - granted));
+	return max(granted, 0.0);
+}
+
+bool engine_pool::reduce(vector<double> &values)
+{
+	if (values.size() != result_values)
+	{
+		std::stringstream ermsg;
+		ermsg<<"engine_pool: "<<values.size()<<" results instead of "<<result_values;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+	copy(values.begin(), values.end(), shared->results(engines, num_nodes, result_values, engine));
+	barrier();
+
+	if (engine == 0)
+		for (int e = 1; e < engines; e++)
+		{
+			const double *r = shared->results(engines, num_nodes, result_values, e);
+			for (size_t i = 0; i < result_values; i++)
+				values[i] += r[i];
+		}
+	return true;
+}
+
+void engine_pool::leave()
+{
+	if (engine != 0)
+	{
+		// _exit() skips the atexit() drain of the diagnostic streams.
+		diag_stream::flush_all();
+		cout.flush();
+		fflush(NULL);
+		_exit(0);
+	}
+	for (unsigned i = 0; i < children.size(); i++)
+	{
+		int status;
+		waitpid(children[i], &status, 0);
+	}
+	children.clear();
+}
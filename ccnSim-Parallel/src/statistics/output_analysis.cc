@@ -0,0 +1,146 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "output_analysis.h"
+#include <cmath>
+#include <boost/math/distributions/students_t.hpp>
+
+#define MSER_BATCH 5
+
+int output_series::mser5(int min_batches) const
+{
+	int m = values.size() / MSER_BATCH;
+	if (m < min_batches || m < 2)
+		return -1;
+
+	vector<double> z(m);
+	for (int j = 0; j < m; j++)
+	{
+		double sum = 0;
+		for (int i = 0; i < MSER_BATCH; i++)
+			sum += values[j*MSER_BATCH + i];
+		z[j] = sum / MSER_BATCH;
+	}
+
+	// Suffix sums: MSER(d) = sum_{j>=d} (z_j - mean_d)^2 / (m-d)^2 for all d in O(m).
+	double sum = 0, sum2 = 0;
+	vector<double> mser(m/2 + 1);
+	for (int d = m - 1; d >= 0; d--)
+	{
+		sum += z[d];
+		sum2 += z[d]*z[d];
+		if (d <= m/2)
+		{
+			double k = m - d;
+			mser[d] = std::max(0.0, sum2 - sum*sum/k) / (k*k);
+		}
+	}
+	int best = 0;
+	for (int d = 1; d <= m/2; d++)
+		if (mser[d] < mser[best])
+			best = d;
+	return best < m/2 ? best*MSER_BATCH : -1;
+}
+
+bool output_series::batch_means(int batches, double confidence, double &mean, double &half_width) const
+{
+	int n = values.size();
+	if (batches < 2 || n < batches)
+		return false;
+	int size = n / batches;
+	int first = n - size*batches;
+
+	double sum = 0, sum2 = 0;
+	for (int j = 0; j < batches; j++)
+	{
+		double batch = 0;
+		for (int i = 0; i < size; i++)
+			batch += values[first + j*size + i];
+		batch /= size;
+		sum += batch;
+		sum2 += batch*batch;
+	}
+	mean = sum / batches;
+	double var = std::max(0.0, (sum2 - batches*mean*mean) / (batches - 1));
+
+	boost::math::students_t t(batches - 1);
+	double quantile = boost::math::quantile(boost::math::complement(t, (1 - confidence)/2));
+	half_width = quantile * sqrt(var / batches);
+	return true;
+}
+
+void output_analysis::init(int num_nodes, int num_batches, double conf, bool nodes)
+{
+	batches = num_batches;
+	confidence = conf;
+	per_node = nodes;
+	series.assign(per_node ? num_nodes + 1 : 1, output_series());
+}
+
+void output_analysis::clear()
+{
+	for (unsigned s = 0; s < series.size(); s++)
+		series[s].clear();
+}
+
+int output_analysis::warm_up() const
+{
+	int truncation = series[0].mser5(batches);
+	for (unsigned s = 1; s < series.size() && truncation >= 0; s++)
+		if (series[s].size() > 0 && series[s].mser5(batches) < 0)
+			truncation = -1;
+	return truncation;
+}
+
+/*
+ * The check is done only when the batches of the network series grow, so that
+ * the stopping rule does not chase the fluctuations of the variance estimate.
+ */
+bool output_analysis::precise(double precision) const
+{
+	if (series[0].size() == 0 || series[0].size() % batches != 0)
+		return false;
+	for (unsigned s = 0; s < series.size(); s++)
+	{
+		if (s > 0 && series[s].size() == 0)
+			continue;
+		double mean, half_width;
+		if (!series[s].batch_means(batches, confidence, mean, half_width))
+			return false;
+		if (half_width > precision * fabs(mean))
+			return false;
+	}
+	return true;
+}
+
+bool output_analysis::estimate(double &mean, double &half_width) const
+{
+	return series[0].batch_means(batches, confidence, mean, half_width);
+}
@@ -0,0 +1,310 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "result_store.h"
+#include "error_handling.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+uint32_t result_dictionary::id(const string &s)
+{
+	unordered_map<string, uint32_t>::iterator it = ids.find(s);
+	if (it != ids.end())
+		return it->second;
+	uint32_t i = names.size();
+	names.push_back(s);
+	ids[s] = i;
+	return i;
+}
+
+int result_dictionary::find(const string &s) const
+{
+	unordered_map<string, uint32_t>::const_iterator it = ids.find(s);
+	return it == ids.end() ? -1 : (int)it->second;
+}
+
+void split_scalar_name(const string &scalar, string &metric, int32_t &node)
+{
+	size_t open = scalar.rfind('[');
+	if (open != string::npos && open > 0 && scalar[scalar.size()-1] == ']' && open + 2 < scalar.size())
+	{
+		char *end;
+		long n = strtol(scalar.c_str() + open + 1, &end, 10);
+		if (end == scalar.c_str() + scalar.size() - 1)
+		{
+			metric = scalar.substr(0, open);
+			node = n;
+			return;
+		}
+	}
+	metric = scalar;
+	node = -1;
+}
+
+void result_writer::add(const string &run, const string &module, const string &scalar, double value)
+{
+	string metric;
+	int32_t node;
+	split_scalar_name(scalar, metric, node);
+	add(runs.id(run), modules.id(module), node, metrics.id(metric), value);
+}
+
+void result_writer::add(uint32_t run, uint32_t module, int32_t node, uint32_t metric, double value)
+{
+	values.push_back(value);
+	run_col.push_back(run);
+	module_col.push_back(module);
+	metric_col.push_back(metric);
+	node_col.push_back(node);
+}
+
+void result_writer::clear()
+{
+	values.clear();
+	run_col.clear();
+	module_col.clear();
+	metric_col.clear();
+	node_col.clear();
+	runs = modules = metrics = result_dictionary();
+}
+
+static void put(FILE *f, const void *p, size_t n)
+{
+	if (n > 0 && fwrite(p, 1, n, f) != n)
+		severe_error(__FILE__,__LINE__,"Unable to write the result file");
+}
+
+template <class T>
+static void put_column(FILE *f, const vector<T> &col, const vector<size_t> &order, size_t from, size_t to)
+{
+	vector<T> block(to - from);
+	for (size_t i = from; i < to; i++)
+		block[i - from] = col[order[i]];
+	put(f, block.data(), block.size() * sizeof(T));
+}
+
+static void put_dictionary(FILE *f, const result_dictionary &dict)
+{
+	uint32_t n = dict.size();
+	put(f, &n, sizeof(n));
+	for (uint32_t i = 0; i < n; i++)
+	{
+		uint32_t len = dict.name(i).size();
+		put(f, &len, sizeof(len));
+		put(f, dict.name(i).data(), len);
+	}
+}
+
+void result_writer::write(const char *path)
+{
+	FILE *f = fopen(path, "wb");
+	if (f == NULL)
+	{
+		std::stringstream ermsg;
+		ermsg<<"Unable to open the result file "<<path;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	put(f, RESULT_MAGIC, RESULT_MAGIC_LEN);
+
+	vector<size_t> order(values.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	sort(order.begin(), order.end(), [this](size_t a, size_t b){
+		if (metric_col[a] != metric_col[b]) return metric_col[a] < metric_col[b];
+		if (run_col[a] != run_col[b]) return run_col[a] < run_col[b];
+		if (module_col[a] != module_col[b]) return module_col[a] < module_col[b];
+		return node_col[a] < node_col[b];
+	});
+
+	vector<result_block> index;
+	uint64_t offset = RESULT_MAGIC_LEN;
+	for (size_t from = 0; from < order.size(); from += RESULT_BLOCK)
+	{
+		size_t to = min(order.size(), from + RESULT_BLOCK);
+		result_block b;
+		b.offset = offset;
+		b.rows = to - from;
+		b.run_min = b.metric_min = UINT32_MAX;
+		b.run_max = b.metric_max = 0;
+		for (size_t i = from; i < to; i++)
+		{
+			b.run_min = min(b.run_min, run_col[order[i]]);
+			b.run_max = max(b.run_max, run_col[order[i]]);
+			b.metric_min = min(b.metric_min, metric_col[order[i]]);
+			b.metric_max = max(b.metric_max, metric_col[order[i]]);
+		}
+		put_column(f, values, order, from, to);
+		put_column(f, run_col, order, from, to);
+		put_column(f, module_col, order, from, to);
+		put_column(f, metric_col, order, from, to);
+		put_column(f, node_col, order, from, to);
+		offset += (uint64_t)b.rows * (sizeof(double) + 4*sizeof(uint32_t));
+		index.push_back(b);
+	}
+
+	uint64_t footer = offset;
+	put_dictionary(f, runs);
+	put_dictionary(f, modules);
+	put_dictionary(f, metrics);
+	uint32_t n = index.size();
+	put(f, &n, sizeof(n));
+	for (uint32_t i = 0; i < n; i++)
+	{
+		put(f, &index[i].offset, sizeof(index[i].offset));
+		put(f, &index[i].rows, 5*sizeof(uint32_t));
+	}
+	put(f, &footer, sizeof(footer));
+	put(f, RESULT_MAGIC, RESULT_MAGIC_LEN);
+	if (fclose(f) != 0)
+		severe_error(__FILE__,__LINE__,"Unable to write the result file");
+}
+
+void result_reader::corrupted(size_t pos)
+{
+	std::stringstream ermsg;
+	ermsg<<path<<" is not a valid result file (offset "<<pos<<")";
+	severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+}
+
+void result_reader::read_dictionary(size_t &pos, result_dictionary &dict)
+{
+	uint32_t n;
+	if (pos + sizeof(n) > size)
+		corrupted(pos);
+	memcpy(&n, data + pos, sizeof(n));
+	pos += sizeof(n);
+	for (uint32_t i = 0; i < n; i++)
+	{
+		uint32_t len;
+		if (pos + sizeof(len) > size)
+			corrupted(pos);
+		memcpy(&len, data + pos, sizeof(len));
+		pos += sizeof(len);
+		if (pos + len > size)
+			corrupted(pos);
+		dict.id(string((const char *)data + pos, len));
+		pos += len;
+	}
+}
+
+void result_reader::open(const char *file_path)
+{
+	close();
+	path = file_path;
+	int fd = ::open(file_path, O_RDONLY);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0)
+	{
+		std::stringstream ermsg;
+		ermsg<<"Unable to open the result file "<<path;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	size = st.st_size;
+	if (size < 2*RESULT_MAGIC_LEN + sizeof(uint64_t))
+		corrupted(0);
+	void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (map == MAP_FAILED)
+		corrupted(0);
+	data = (const unsigned char *)map;
+
+	if (memcmp(data, RESULT_MAGIC, RESULT_MAGIC_LEN) != 0 ||
+		memcmp(data + size - RESULT_MAGIC_LEN, RESULT_MAGIC, RESULT_MAGIC_LEN) != 0)
+		corrupted(0);
+	uint64_t footer;
+	memcpy(&footer, data + size - RESULT_MAGIC_LEN - sizeof(footer), sizeof(footer));
+	size_t end = size - RESULT_MAGIC_LEN - sizeof(footer);
+	if (footer < RESULT_MAGIC_LEN || footer > end)
+		corrupted(0);
+
+	size_t pos = footer;
+	read_dictionary(pos, run_dict);
+	read_dictionary(pos, module_dict);
+	read_dictionary(pos, metric_dict);
+	uint32_t n;
+	if (pos + sizeof(n) > end)
+		corrupted(pos);
+	memcpy(&n, data + pos, sizeof(n));
+	pos += sizeof(n);
+	index.resize(n);
+	for (uint32_t i = 0; i < n; i++)
+	{
+		result_block &b = index[i];
+		if (pos + sizeof(b.offset) + 5*sizeof(uint32_t) > end)
+			corrupted(pos);
+		memcpy(&b.offset, data + pos, sizeof(b.offset));
+		memcpy(&b.rows, data + pos + sizeof(b.offset), 5*sizeof(uint32_t));
+		pos += sizeof(b.offset) + 5*sizeof(uint32_t);
+		if (b.offset % sizeof(double) != 0 ||
+			b.offset + (uint64_t)b.rows * (sizeof(double) + 4*sizeof(uint32_t)) > footer)
+			corrupted(pos);
+	}
+}
+
+void result_reader::close()
+{
+	if (data != NULL)
+		munmap((void *)data, size);
+	data = NULL;
+	size = 0;
+	run_dict = module_dict = metric_dict = result_dictionary();
+	index.clear();
+}
+
+const double *result_reader::value_column(unsigned b) const
+{
+	return (const double *)(data + index[b].offset);
+}
+
+const uint32_t *result_reader::run_column(unsigned b) const
+{
+	return (const uint32_t *)(data + index[b].offset + index[b].rows * sizeof(double));
+}
+
+const uint32_t *result_reader::module_column(unsigned b) const
+{
+	return run_column(b) + index[b].rows;
+}
+
+const uint32_t *result_reader::metric_column(unsigned b) const
+{
+	return module_column(b) + index[b].rows;
+}
+
+const int32_t *result_reader::node_column(unsigned b) const
+{
+	return (const int32_t *)(metric_column(b) + index[b].rows);
+}
@@ -0,0 +1,165 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "socket_coordinator.h"
+#include "error_handling.h"
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define CONNECT_TIMEOUT_MS 60000		// The daemon may be started after the engines.
+
+
+socket_coordinator::socket_coordinator(const string &socket_path)
+{
+	path = socket_path;
+	fd = -1;
+	engines = 1;
+	num_nodes = 0;
+	window = 0;
+	partial_n = 0;
+}
+
+socket_coordinator::~socket_coordinator()
+{
+	if (fd >= 0)
+		close(fd);
+}
+
+int socket_coordinator::start(int num_engines, int nodes, int node_window, int partial)
+{
+	engines = num_engines;
+	num_nodes = nodes;
+	window = node_window;
+	partial_n = partial;
+
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path))
+	{
+		std::stringstream ermsg;
+		ermsg<<"socket_coordinator: socket path too long: "<<path;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+	strcpy(addr.sun_path, path.c_str());
+
+	for (int waited_ms = 0; ; waited_ms += 100)
+	{
+		fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+			break;
+		if (fd >= 0)
+			close(fd);
+		fd = -1;
+		if (waited_ms >= CONNECT_TIMEOUT_MS)
+		{
+			std::stringstream ermsg;
+			ermsg<<"socket_coordinator: cannot connect to the coordinator daemon at "<<path<<": "<<strerror(errno);
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+		}
+		usleep(100000);
+	}
+
+	coord_request req;
+	memset(&req, 0, sizeof(req));
+	req.type = COORD_HELLO;
+	req.amount = budget;
+	return request(req).value;
+}
+
+coord_reply socket_coordinator::request(coord_request &req, const node_summary *records)
+{
+	req.engines = engines;
+	req.num_nodes = num_nodes;
+	req.window = window;
+	req.partial_n = partial_n;
+
+	coord_reply reply;
+	if (!write_all(fd, &req, sizeof(req))
+			|| (req.records > 0 && !write_all(fd, records, req.records*sizeof(node_summary)))
+			|| !read_all(fd, &reply, sizeof(reply)))
+	{
+		std::stringstream ermsg;
+		ermsg<<"socket_coordinator: connection to the coordinator daemon at "<<path<<" lost";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+	return reply;
+}
+
+bool socket_coordinator::stable(stability_window &windows, double cv_thr)
+{
+	changes.clear();
+	windows.take_changes(changes);
+
+	coord_request req;
+	memset(&req, 0, sizeof(req));
+	req.type = COORD_STABLE;
+	req.records = changes.size();
+	req.threshold = cv_thr;
+	coord_reply reply = request(req, changes.empty() ? NULL : &changes[0]);
+	last_stables = reply.value;
+	return reply.verdict != 0;
+}
+
+bool socket_coordinator::consistent(double measured, double target, double cons_thr)
+{
+	coord_request req;
+	memset(&req, 0, sizeof(req));
+	req.type = COORD_CONSISTENT;
+	req.measured = measured;
+	req.target = target;
+	req.threshold = cons_thr;
+	return request(req).verdict != 0;
+}
+
+double socket_coordinator::claim(double chunk)
+{
+	coord_request req;
+	memset(&req, 0, sizeof(req));
+	req.type = COORD_CLAIM;
+	req.amount = chunk;
+	return request(req).amount;
+}
+
+void socket_coordinator::leave()
+{
+	if (fd < 0)
+		return;
+	coord_request req;
+	memset(&req, 0, sizeof(req));
+	req.type = COORD_BYE;
+	request(req);
+	close(fd);
+	fd = -1;
+}
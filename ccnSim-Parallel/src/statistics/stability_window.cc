@@ -0,0 +1,178 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "stability_window.h"
+#include <algorithm>
+
+static inline bool valid_sample(int64_t hit, int64_t miss)
+{
+	return hit >= 0 && hit + miss > 0;
+}
+
+static inline double hit_ratio(int64_t hit, int64_t miss)
+{
+	return hit * 1./(hit + miss);
+}
+
+void stability_window::init(int nodes, int node_window)
+{
+	num_nodes = nodes;
+	window = node_window;
+	hits.assign((size_t)num_nodes*window, -1);
+	misses.assign((size_t)num_nodes*window, -1);
+	taken.assign(num_nodes, 0);
+	summary.resize(num_nodes);
+	changed.assign(num_nodes, 0);
+	changed_nodes.clear();
+	reset();
+}
+
+void stability_window::reset()
+{
+	fill(hits.begin(), hits.end(), -1);
+	fill(misses.begin(), misses.end(), -1);
+	for (int n = 0; n < num_nodes; n++)
+	{
+		taken[n] = 0;
+		summary[n].node = n;
+		summary[n].count = 0;
+		summary[n].taken = 0;
+		summary[n].mean = 0;
+		summary[n].m2 = 0;
+		mark(n);
+	}
+}
+
+void stability_window::mark(int node)
+{
+	if (!changed[node])
+	{
+		changed[node] = 1;
+		changed_nodes.push_back(node);
+	}
+}
+
+/*
+ * The sample leaving the window is removed from the summary (Welford's update
+ * in reverse); the summary is recomputed from the window each time the window
+ * wraps, so that rounding errors do not accumulate.
+ */
+void stability_window::add(int node, int64_t hit, int64_t miss)
+{
+	int slot = taken[node] % window;
+	size_t i = (size_t)node*window + slot;
+	node_summary &s = summary[node];
+
+	if (taken[node] >= window && valid_sample(hits[i], misses[i]))
+	{
+		double x = hit_ratio(hits[i], misses[i]);
+		if (s.count == 1)
+			s.mean = s.m2 = 0;
+		else
+		{
+			double old_mean = s.mean;
+			s.mean = (s.count * s.mean - x)/(s.count - 1);
+			s.m2 -= (x - old_mean)*(x - s.mean);
+			if (s.m2 < 0)
+				s.m2 = 0;
+		}
+		s.count--;
+	}
+
+	hits[i] = hit;
+	misses[i] = miss;
+	if (valid_sample(hit, miss))
+	{
+		double x = hit_ratio(hit, miss);
+		s.count++;
+		double delta = x - s.mean;
+		s.mean += delta/s.count;
+		s.m2 += delta*(x - s.mean);
+	}
+
+	taken[node]++;
+	s.taken = min(taken[node], window);
+	if (taken[node] % window == 0)
+		recompute(node);
+	mark(node);
+}
+
+void stability_window::recompute(int node)
+{
+	node_summary &s = summary[node];
+	s.count = 0;
+	s.mean = s.m2 = 0;
+	for (size_t i = (size_t)node*window; i < (size_t)(node+1)*window; i++)
+	{
+		if (!valid_sample(hits[i], misses[i]))
+			continue;
+		double x = hit_ratio(hits[i], misses[i]);
+		s.count++;
+		double delta = x - s.mean;
+		s.mean += delta/s.count;
+		s.m2 += delta*(x - s.mean);
+	}
+}
+
+int stability_window::full_nodes() const
+{
+	int full_count = 0;
+	for (int n = 0; n < num_nodes; n++)
+		if (full(n))
+			full_count++;
+	return full_count;
+}
+
+void stability_window::take_changes(vector<node_summary> &records)
+{
+	for (unsigned k = 0; k < changed_nodes.size(); k++)
+	{
+		int n = changed_nodes[k];
+		records.push_back(summary[n]);
+		changed[n] = 0;
+	}
+	changed_nodes.clear();
+}
+
+void stability_window::hit_miss(int *out) const
+{
+	size_t half = (size_t)num_nodes*window;
+	for (int n = 0; n < num_nodes; n++)
+	{
+		// The oldest sample is the next slot to be overwritten.
+		int first = taken[n] >= window ? taken[n] % window : 0;
+		for (int z = 0; z < window; z++)
+		{
+			size_t from = (size_t)n*window + (first + z) % window;
+			out[(size_t)n*window + z] = (int)hits[from];		// The master takes 32-bit counters.
+			out[half + (size_t)n*window + z] = (int)misses[from];
+		}
+	}
+}
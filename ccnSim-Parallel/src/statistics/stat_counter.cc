@@ -0,0 +1,125 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "stat_counter.h"
+#include "error_handling.h"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+vector<uint64_t *> stat_registry::pages[STAT_SHARDS];
+vector<unsigned> stat_registry::free_slots;
+unsigned stat_registry::slots = 0;
+atomic<int> stat_registry::threads(0);
+
+// Counters are attached while the modules are built, which is not a hot path.
+static std::mutex registry_lock;
+
+void stat_registry::attach(stat_counter &counter)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	unsigned id;
+	if (free_slots.empty())
+	{
+		id = slots++;
+		if (id % STAT_PAGE_SLOTS == 0)
+			for (int s = 0; s < STAT_SHARDS; s++)
+			{
+				void *page;
+				if (posix_memalign(&page, STAT_PAGE_SLOTS*sizeof(uint64_t), STAT_PAGE_SLOTS*sizeof(uint64_t)) != 0)
+					severe_error(__FILE__,__LINE__,"Unable to allocate a page of statistics counters");
+				memset(page, 0, STAT_PAGE_SLOTS*sizeof(uint64_t));
+				pages[s].push_back((uint64_t *)page);
+			}
+	}
+	else
+	{
+		id = free_slots.back();
+		free_slots.pop_back();
+	}
+
+	counter.id = id;
+	for (int s = 0; s < STAT_SHARDS; s++)
+	{
+		counter.cell[s] = pages[s][id / STAT_PAGE_SLOTS] + id % STAT_PAGE_SLOTS;
+		*counter.cell[s] = 0;
+	}
+}
+
+void stat_registry::detach(stat_counter &counter)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	counter.clear();
+	free_slots.push_back(counter.id);
+}
+
+int stat_registry::next_shard()
+{
+	int t = threads++;
+	if (t >= STAT_SHARDS)
+	{
+		std::stringstream ermsg;
+		ermsg<<"More than "<<STAT_SHARDS<<" threads update the statistics counters. "<<
+			"Rebuild with a larger STAT_SHARDS";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str());
+	}
+	return t;
+}
+
+/*
+ * The slots of the detached counters are zero, so the snapshot can sum whole
+ * pages. A snapshot taken while other threads are counting is not atomic as a
+ * whole, but each slot is an aligned 64-bit word and is never read torn.
+ */
+void stat_registry::snapshot(vector<uint64_t> &values)
+{
+	values.assign(slots, 0);
+	for (int s = 0; s < STAT_SHARDS; s++)
+		for (unsigned i = 0; i < slots; i++)
+			values[i] += pages[s][i / STAT_PAGE_SLOTS][i % STAT_PAGE_SLOTS];
+}
+
+uint64_t stat_counter::value() const
+{
+	uint64_t sum = 0;
+	for (int s = 0; s < STAT_SHARDS; s++)
+		sum += *cell[s];
+	return sum;
+}
+
+/*
+ * The value is moved into the shard of the calling thread.
+ */
+void stat_counter::set(uint64_t n)
+{
+	for (int s = 0; s < STAT_SHARDS; s++)
+		*cell[s] = 0;
+	*cell[stat_registry::shard()] = n;
+}
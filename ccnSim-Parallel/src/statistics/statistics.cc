@@ -48,10 +48,10 @@
 #include "ttl_name_cache.h"
 
 #include "error_handling.h"
-
-// AKAROA
-#include <akaroa.H>
-#include <akaroa/ak_message.H>
+#include "philox_rng.h"
+#include "engine_pool.h"
+#include "akaroa_coordinator.h"
+#include "socket_coordinator.h"
 
 // SIGNALS
 #include<stdio.h>
@@ -75,63 +75,8 @@ using namespace std;
 
 extern "C" double compute_Tc_single_Approx(double cSizeTarg, double alphaVal, long catCard, float** reqRates, int colIndex, const char* decString, double fixProb);
 extern "C" double compute_Tc_single_Approx_More_Repo(double cSizeTarg, double alphaVal, long catCard, float** reqRates, int colIndex, const char* decString, double fixProb);
-extern "C" void signal_handler(int sigType);
-
 bool stop_simulation = false;
-bool signal_received = false;
-bool steadyState = false;			// It is used when SIGUSR* are received.
-
-void signal_handler(int signo)
-{
-  switch(signo){
-  case 30:				 // SIGUSR1 = Continue
-	  if(!steadyState)   // Still in the "Transient Phase"
-	  {
-		  // The Master node has communicated that the transient phase should continue since the
-		  // centralized stable check (done at the Master) has provided a negative outcome.
-		  char *msg1 = (char *)"SIGUSR1 was CATCHED!! CONTINUE the CENTRALIZED STABLE CHECK!\n";
-		  AkMessage(msg1);
-		  steadyState = false;
-		  signal_received = true;
-		  stop_simulation = false;
-	  }
-	  else				// The simulation is already at "steady-state" and waiting to receive a STOP signal from the Master.
-	  {
-		  // The Master node has communicated that the ModelGraft "consistency check" has provided a negative outcome,
-		  // and thus the simulation should continue with another MC-TTL cycle.
-		  char *msg2 = (char *)"SIGUSR1 was CATCHED!! CONTINUE the simulation with another MC-TTL cycle!\n";
-		  AkMessage(msg2);
-		  steadyState = false;
-		  signal_received = true;
-		  stop_simulation = false;
-	  }
-	  break;
-  case 31:					// SIGUSR1 = Stop
-	  if(!steadyState)		// Still in the "Transient Phase"
-	  {
-		  // The Master node has communicated that the transient phase should be stopped since the
-		  // centralized stable check (done at the Master) has provided a positive outcome.
-		  char *msg3 = (char *)"SIGUSR2 was CATCHED!! STOP the CENTRALIZED STABLE CHECK!\n";
-		  AkMessage (msg3);
-		  steadyState = true;
-		  signal_received = true;
-		  stop_simulation = false;
-	  }
-	  else				// The simulation is already at "steady-state" and waiting to receive a STOP signal from the Master.
-	  {
-		  // The Master node has communicated that the ModelGraft "consistency check" has provided a positive outcome,
-		  // and thus the simulation can be stopped.
-		  char *msg4 = (char *)"SIGUSR2 was CATCHED!! STOP the simulation\n";
-		  AkMessage (msg4);
-		  signal_received = true;
-		  stop_simulation = true;
-	  }
-  	  break;
-  default:
-	  char *msg5 = (char *)"THE RECEIVED SIGNAL IS UNKNOWN!!\n";
-	  AkMessage(msg5);
-  }
-}
+bool steadyState = false;			// Verdict of the last centralized stable check.
 
 void statistics::dbgWithAkaroa(const char* dbgMsg)
 {
@@ -154,34 +99,35 @@ void statistics::init_debug_file()
 
 	full_out_str << debugFilePath << "_HOSTNAME_" << hostname << "_PID_" << pid << out_str;
 
-	dbAk.open (full_out_str.str().c_str(), ofstream::out);
+	dbAk.open (full_out_str.str().c_str());
 }
 
 void statistics::initialize(int stage)
 {
 	if(stage == 1)
 	{
-		// *** AKAROA INITIALIZATION ***
-
-		int numParam = 2;			// We consider the HitMiss vector for the stability, and the measured cache size at the end.
-		AkDeclareParameters(numParam);  // Declare the number of parameters
-
-		char *msg6 = (char *)"Parameters declared:  %i";
-		AkMessage(msg6, numParam);
-
-		// Initialize signal handlers
-		char *msg7 = (char *)"-- INITIATING SIGNLAL HANDLERs!!\n";
-		AkMessage(msg7);
-
-		if (signal(30, signal_handler) == SIG_ERR)		// Signal = Continue (both for stability and end of simulation)
+		string coordinator = par("coordinator").stdstringValue();
+		if (coordinator == "akaroa")
+			coord = new akaroa_coordinator();
+		else if (coordinator == "local")
+			coord = new engine_pool();
+		else if (coordinator == "socket")
+			coord = new socket_coordinator(par("coordinator_socket").stdstringValue());
+		else
 		{
-			char *msg8 = (char *)"\ncan't catch SIGUSR1\n";
-			AkMessage(msg8);
+			std::stringstream ermsg;
+			ermsg<<"Unknown coordinator \""<<coordinator<<"\" (akaroa | local | socket)";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
 		}
-		if (signal(31, signal_handler) == SIG_ERR)		// Signal = Stop (both for stability and end of simulation)
+
+		budget_chunks = par("budget_chunks");
+		steady_claimed = 0;
+
+		if (coordinator != "akaroa" && cSimulation::getActiveEnvir()->getParsimNumPartitions() > 1)
 		{
-			char *msg9 = (char *)"\ncan't catch SIGUSR2\n";
-			AkMessage(msg9);
+			std::stringstream ermsg;
+			ermsg<<"The "<<coordinator<<" coordinator cannot be used in parsim runs";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
 		}
 
 		// **********************************
@@ -201,11 +147,11 @@ void statistics::initialize(int stage)
 		window = par("window");
 
 		num_threads = par("num_threads");
-		//engineWindow = floor(window * 1./num_threads);    // We need to send this sizeVect to the master
+		//engineWindow = floor(window * 1./num_threads);    // We need to send this window size to the master
 		if(num_threads == 1)
-			engineWindow = window;    // We need to send this sizeVect to the master
+			engineWindow = window;    // We need to send this window size to the master
 		else
-			engineWindow = floor(window/num_threads);    // We need to send this sizeVect to the master
+			engineWindow = floor(window/num_threads);    // We need to send this window size to the master
 
 		if(engineWindow < 10)
 		{
@@ -220,23 +166,12 @@ void statistics::initialize(int stage)
 		dbAk << "NUMBER OF CORES:\t" << num_threads << endl;
 		dbAk << "ENGINE WINDOW SIZE:\t" << engineWindow << endl;
 
-		/* Init vectors that are sent to the Master for the Centralized Stable Check.
-		 * Each node will collect 2*engineWindow samples, i.e., 'engineWindow' Hit and Miss measures.
-		 * The size of the whole vector sent to the Master from each Engine will be 'num_nodes*2*engineWindow'
-		 * The collection of samples will be executed each "Ts" seconds; if a valid sample is not available,
-		 * the default "-1" value will be left, meaning that no sample has been collected.
+		/* Init the windows used for the Centralized Stable Check.
+		 * Each node keeps its last 'engineWindow' Hit and Miss samples, collected each "Ts" seconds,
+		 * and their running summary: only the summaries of the nodes that have changed are sent to
+		 * the Master, and the samples are kept across the checks.
 		*/
-		sizeVect = num_nodes*2*engineWindow;
-    	HitMiss = new int[sizeVect];
-    	for(int i=0; i<sizeVect; i++)
-    		HitMiss[i] = -1;				// Initialized to '-1', which means 'sample not collected'
-
-    	// Initialize the counter of samples (used to trigger HitMiss vector sending)
-    	sample_counter.resize(num_nodes);
-    	for (int j=0; j<num_nodes; j++)
-    	{
-    		sample_counter[j] = 0;
-    	}
+		hit_windows.init(num_nodes, (int)engineWindow);
 
 
 		// Only model solver of entire simulation
@@ -278,6 +213,25 @@ void statistics::initialize(int stage)
         cvThr = par("cvThr");
         consThr = par("consThr");
 
+		ci_precision = par("ci_precision");
+		if (ci_precision > 0)
+		{
+			if (num_threads > 1)
+			{
+				std::stringstream ermsg;
+				ermsg<<"The in-engine output analysis (ci_precision > 0) needs a single engine (num_threads = 1)";
+				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+			}
+			if (budget_chunks > 0)
+			{
+				// The early end of the steady phase would be undone by the next chunk of the budget.
+				std::stringstream ermsg;
+				ermsg<<"The in-engine output analysis (ci_precision > 0) cannot end a shared steady phase (budget_chunks > 0)";
+				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+			}
+			analysis.init(num_nodes, par("ci_batches"), par("ci_confidence"), par("ci_per_node"));
+		}
+
 		if (partial_n < 0 || partial_n > 1)
 		{
 			std::stringstream ermsg;
@@ -381,6 +335,9 @@ void statistics::initialize(int stage)
 
 		centralized_stable_check = new cMessage("centralized_stable_check",CENTRALIZED_STABLE_CHECK);
 		end = new cMessage("end",END);
+		precision_check = new cMessage("precision_check",PRECISION_CHECK);
+		analysis_hit.assign(num_nodes, 0);
+		analysis_miss.assign(num_nodes, 0);
 
 		dbAk << endl;
 
@@ -394,6 +351,9 @@ void statistics::initialize(int stage)
 		}
 		else
 		{
+			// The engines join the coordinator (local engines are forked) once the
+			// whole network has been initialized.
+			scheduleAt(simTime(), new cMessage("start_engines",START_ENGINES));
 			scheduleAt(simTime() + ts, centralized_stable_check);  // Schedule a centralized stable check.
 		}
 	}
@@ -406,7 +366,7 @@ int statistics::numInitStages() const
 
 /*
  * 	Handle timers aimed at checking the state of the simulation, e.g.,
- * 	if HitMiss vector can be sent to Master, or End of the simulation.
+ * 	if the windows can be sent to Master, or End of the simulation.
  */
 void statistics::handleMessage(cMessage *in)
 {
@@ -415,161 +375,203 @@ void statistics::handleMessage(cMessage *in)
     double phitNode;
     double phitTot = 0;
     int pid = 0;
-    int numValidNodes = 0;
-    int paramNum;
 
     switch (in->getKind()){
 
+    case START_ENGINES:
+    {
+    	delete in;
+    	dbAk.flush();
+    	pid = getpid();
+    	if (budget_chunks > 0)
+    		coord->set_budget(num_threads * time_steady);
+    	collect_results(merged_results);
+    	coord->set_results(merged_results.size());
+    	merged_results.clear();
+    	int engine = coord->start(num_threads, num_nodes, (int)engineWindow, (int)partial_n);
+    	if (getpid() != pid)
+    	{
+    		// A forked engine has its own log.
+    		dbAk.close();
+    		init_debug_file();
+    	}
+    	// Each engine has its own random streams. The clients drew their first
+    	// arrivals before the engines were started, so they draw them again.
+    	if (coord->indexed_streams() && num_threads > 1)
+    	{
+    		if (!philox_rng::set_engine(engine))
+    		{
+    			std::stringstream ermsg;
+    			ermsg<<"Parallel engines need independent random streams: use rng-class = \"philox_rng\"";
+    			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+    		}
+    		for (int i = 0; i < num_clients; i++)
+    			clients[i]->restart_arrivals();
+    	}
+    	dbAk << "ENGINE # " << engine << " of " << num_threads << "\tPID:\t" << getpid() << endl;
+    	break;
+    }
+
     case CENTRALIZED_STABLE_CHECK:
+    	stat_registry::snapshot(counters);
     	for (int i = 0;i<num_nodes;i++)
     	{
  			centralized_stable(i);				// Collect only valid samples from each node.
     	}
 
-    	// The HitMiss vector will be sent to the Master after the first "partial_n" nodes have collect engineWindow Hit and Miss samples.
+    	// The windows will be sent to the Master after the first "partial_n" nodes have collect engineWindow Hit and Miss samples.
     	// In this way we avoid that peripheral nodes (or the ones that are not traversed by a relevant traffic) could
     	// slow down the entire process of sampling collection and sending to the Master.
-    	// The whole sent vector might, then, partially contain also default values (i.e., '-1') for some nodes.
+    	// The windows of some nodes might, then, be still incomplete.
 
-    	// Indeed, checks like "stables >= partial_n" and "stable_with_traffic >= floor(partial_n/2)" will be done by the Master.
+    	// Indeed, checks like "stables >= partial_n" and "stable_with_traffic >= floor(partial_n/2)" will be done by the Master
+    	// (see master_stable(), where the nodes whose windows hold only samples without traffic are stable).
     	// stable_nodes[]=true/false should be, as a consequence, set from the Master in order to do the control above.
     	// Moreover, "caches[]->stability", "clients[]->stability" should be set after having received the right signal from the Master.
 
-    	for (int j=0; j<num_nodes; j++)
+    	if (ci_precision > 0)
     	{
-    		if(sample_counter[j] == engineWindow)
-    			numValidNodes++;
+    		// In-engine output analysis: the transient is over when MSER-5 finds the truncation point of the hit ratio.
+    		sample_hit_ratios();
+    		int truncation = analysis.warm_up();
+    		steadyState = truncation >= 0;
+    		if (steadyState)
+    			dbAk << "MSER-5 truncation: " << truncation << " of " << analysis.network().size() << " samples" << endl;
     	}
-
-    	if(numValidNodes >= partial_n)
+    	else if(hit_windows.full_nodes() >= partial_n)
     	{
-			// *** AKAROA *** Observations are sent to the Master and marked with the pid = process ID of the current engine.
-			pid = getpid();
-			paramNum = 2;
-
+			// Send the windows to the Master: the engine blocks until its verdict.
+			steadyState = coord->stable(hit_windows, cvThr);
+			dbAk << "Centralized stable check: " << (steadyState ? "STABLE" : "CONTINUE");
+			if (coord->stable_nodes() >= 0)
+				dbAk << " (" << coord->stable_nodes() << " stable nodes)";
+			dbAk << endl;
+    	}
+    	else	// Not enough nodes have collected the valid amount of samples.
+    		steadyState = false;
 
-			/* // Can be used for Debugging
-			dbAk << "I'm sending these samples:" << endl;
-			for (int j=0; j<num_nodes; j++)
-			{
-				for (int z=0; z<engineWindow; z++)
-				{
-					if(HitMiss[(j*(int)engineWindow)+z] > 0)
-						dbAk << "PID # " << pid << "\t NODE # " << j << "\t SAMPLE # " << z << "\t VALUE - "<< HitMiss[(j*(int)engineWindow)+z] << endl;
-				}
-			}*/
+		if(steadyState)  // It means that the Master has 'stated' the steady-state after the centralized stable check.
+		{
+			// Set flags for caches and clients
+			for (int i = 0;i<num_nodes;i++)
+				caches[i]->stability = true;
 
-			/*
-			 *   Function used to send the HitMiss vector to the Master
-			 *
-			 *   Param:
-			 *   - paramNum: it specifies the number associated to the the checkpoint (metric) that we are sending to the Mastr.
-			 *   			 In out case, for the HitMiss vector, paramNum = 2, while for the MeasCacheSize sent at the and of the
-			 *   			 simulation it will be paramNum = 1. This number will be used by the Master to differentiate the
-			 *   			 checkpoint processing.
-			 *   - HitMiss: it is the  vector with the collected samples for all the nodes.
-			 *   - num_nodes: it specifies the total number of nodes.
-			 *   - engineWindow: size of the window of samples for each node.
-			 *   - partial_n: actual number of nodes for which the check will be done (usually < numNodes).
-			 *   - pid = process id of the current engine.
-			 *   - num_threads = number of parallel threads which are executing the current simulation.
-			 */
-			AkObservationMGvect(paramNum, HitMiss, num_nodes, (int)engineWindow, partial_n, pid, num_threads);
-
-			// Waiting for any Signal to be received from the Master
-			while(!signal_received)
-			{
-				sleep(1);
-			}
+			for(int i=0; i<num_clients; i++)
+				clients[i]->stability = true;
 
-			sleep(1);
+			dbAk << "*** FULL STABLE ***" << endl;
 
-			if(steadyState)  // It means that the Master has 'stated' the steady-state after the centralized stable check.
+			// Compute HIT rate for active nodes on the current Engine.
+			// (It does not make much sense here, since it is the Master that should do this with samples from all the engines
+			//	It can be used to keep track of the different system evolutions for the different Engines).
+			phitTot = 0;
+			numActiveNodes = 0;
+			for (int i=0; i < num_nodes; i++)
 			{
-				// The signal_received is set again to 'false' in order to wait for the 'end_of_sim' signal.
-				signal_received = false;
-
-				// Set flags for caches and clients
-				for (int i = 0;i<num_nodes;i++)
-					caches[i]->stability = true;
-
-				for(int i=0; i<num_clients; i++)
-					clients[i]->stability = true;
-
-				dbAk << "*** FULL STABLE ***" << endl;
-
-				// Compute HIT rate for active nodes on the current Engine.
-				// (It does not make much sense here, since it is the Master that should do this with samples from all the engines
-				//	It can be used to keep track of the different system evolutions for the different Engines).
-				phitTot = 0;
-				numActiveNodes = 0;
-				for (int i=0; i < num_nodes; i++)
+				if(cores[i]->interests.value() != 0)
 				{
-					if(cores[i]->interests != 0)
-					{
-						dbAk << "**(stable) NODE # " << i << ":\tHITS = " << caches[i]->hit << "\tMISS = " << caches[i]->miss << endl;
-						phitNode = caches[i]->hit * 1./ ( caches[i]->hit + caches[i]->miss );
-						phitTot += phitNode;
-						dbAk << "Node # " << i << " pHit: " << phitNode << endl;
-						phitNode = 0;
-						numActiveNodes++;
-						cores[i]->stable = true;
-					}
-					else
-					{
-						phitTot += 0;
-						cores[i]->stable = true;
-					}
+					uint64_t hits = caches[i]->hit.value(), misses = caches[i]->miss.value();
+					DIAG(DIAG_DEBUG, dbAk) << "**(stable) NODE # " << i << ":\tHITS = " << hits << "\tMISS = " << misses << endl;
+					phitNode = hits * 1./ ( hits + misses );
+					phitTot += phitNode;
+					DIAG(DIAG_DEBUG, dbAk) << "Node # " << i << " pHit: " << phitNode << endl;
+					phitNode = 0;
+					numActiveNodes++;
+					cores[i]->stable = true;
 				}
+				else
+				{
+					phitTot += 0;
+					cores[i]->stable = true;
+				}
+			}
 
-				dbAk << "SIMULATION - Total MEAN HIT PROB AFTER STABILIZATION: " << phitTot * 1./(double)numActiveNodes << endl;
-				dbAk << "Number of Active Nodes: " << numActiveNodes << endl;
-				dbAk << "Simulation - STABILIZATION reached at: " << simTime() << endl;  // Simulation time
+			dbAk << "SIMULATION - Total MEAN HIT PROB AFTER STABILIZATION: " << phitTot * 1./(double)numActiveNodes << endl;
+			dbAk << "Number of Active Nodes: " << numActiveNodes << endl;
+			dbAk << "Simulation - STABILIZATION reached at: " << simTime() << endl;  // Simulation time
 
-				// ** Actual CPU time for stability measured since the beginning
-				tEndStable = chrono::high_resolution_clock::now();
-				auto duration = chrono::duration_cast<chrono::milliseconds>( tEndStable - tStartGeneral ).count();
-				dbAk << "Execution time of the STABILIZATION [ms]: " << duration << endl;
+			// ** Actual CPU time for stability measured since the beginning
+			tEndStable = chrono::high_resolution_clock::now();
+			auto duration = chrono::duration_cast<chrono::milliseconds>( tEndStable - tStartGeneral ).count();
+			dbAk << "Execution time of the STABILIZATION [ms]: " << duration << endl;
 
-				stability_has_been_reached();
+			stability_has_been_reached();
 
-				for (int n=0; n < num_nodes; n++)
-					events[n] = 0;
+			for (int n=0; n < num_nodes; n++)
+				events[n] = 0;
 
-				// Schedule the END of the simulation according to the 'time_steady' (i.e., number of requests) after the stabilization
+			// Schedule the END of the simulation according to the 'time_steady' (i.e., number of requests) after the stabilization
+			// or, if the steady phase is shared, after the first chunk of the budget.
+			if (budget_chunks > 0)
+			{
+				steady_claimed = coord->claim(time_steady / budget_chunks);
+				scheduleAt(simTime() + steady_claimed, end);
+			}
+			else
 				scheduleAt(simTime() + time_steady, end);
 
-				// In case of many parallel threads (i.e., > 70), the time_steady might be too small (i.e., even smaller than the stability time)
-				// This can cause a premature ending of the simulation and the necessity to execute another MC-TTL cycle.
-				// It is still an open problem how to solve this.
-				// A workaround (that does not seem to work) might be :
+			// In case of many parallel threads (i.e., > 70), the time_steady might be too small (i.e., even smaller than the stability time)
+			// This can cause a premature ending of the simulation and the necessity to execute another MC-TTL cycle.
+			// It is still an open problem how to solve this (budget_chunks > 0 at least lets the faster engines
+			// simulate a longer steady phase, instead of waiting for the slowest one).
+			// A workaround (that does not seem to work) might be :
 
-				/*if( time_steady < SIMTIME_DBL(simTime()) )  // time_steady is too small (simTime() represents here the stabilization time)
-					scheduleAt(simTime() + SIMTIME_DBL(simTime()), end);
-				else						// schedule the simulation end at time_steady.
-					scheduleAt(simTime() + time_steady, end);
-				*/
-			}
-			else  // The Master has 'stated' that the centralized stable check must continue by collecting other Hit and Miss samples.
+			/*if( time_steady < SIMTIME_DBL(simTime()) )  // time_steady is too small (simTime() represents here the stabilization time)
+				scheduleAt(simTime() + SIMTIME_DBL(simTime()), end);
+			else						// schedule the simulation end at time_steady.
+				scheduleAt(simTime() + time_steady, end);
+			*/
+
+			// The steady phase may end before time_steady, as soon as the estimate is precise enough.
+			if (ci_precision > 0)
 			{
-				signal_received = false;
+				analysis.clear();
+				scheduleAt(simTime() + ts, precision_check);
+			}
+		}
+		else  // The centralized stable check must continue by collecting other Hit and Miss samples.
+		{
+			// The windows slide over the new samples.
+			scheduleAt(simTime() + ts, in);		// Reschedule a centralized_stable_check.
+		}
 
-				for(int i=0; i<sizeVect; i++)	// Reset the HitMiss vector
-					HitMiss[i] = -1;
+	    break;
 
-				// Reset sample_counter for each node.
-				for (int j=0; j<num_nodes; j++)
-					sample_counter[j] = 0;
+    case PRECISION_CHECK:
+    {
+    	stat_registry::snapshot(counters);
+    	sample_hit_ratios();
+    	double mean, half_width;
+    	if (analysis.precise(ci_precision) && analysis.estimate(mean, half_width))
+    	{
+    		dbAk << "Hit ratio " << mean << " +/- " << half_width << " over " << analysis.network().size()
+    			 << " samples: precision reached at " << simTime() << endl;
 
-				scheduleAt(simTime() + ts, in);		// Reschedule a centralized_stable_check.
-			}
-    	} // Not enough nodes have collected the valid amount of samples.
+    		// The steady phase ends now instead of at the 'steady' horizon.
+    		cancelEvent(end);
+    		scheduleAt(simTime(), end);
+    	}
     	else
-    		scheduleAt(simTime() + ts, in);		// Reschedule a centralized_stable_check.
-
-	    break;
+    		scheduleAt(simTime() + ts, in);
+    	break;
+    }
 
     case END:		// The scheduled END of the simulation has come.
+    	cancelEvent(precision_check);
+    	if (budget_chunks > 0)
+    	{
+    		// The steady phase goes on as long as the budget shared by the engines is not exhausted,
+    		// so that the faster engines simulate more of it.
+    		double chunk = coord->claim(time_steady / budget_chunks);
+    		if (chunk > 0)
+    		{
+    			steady_claimed += chunk;
+    			scheduleAt(simTime() + chunk, end);
+    			break;
+    		}
+    		dbAk << "Steady time simulated by this engine: " << steady_claimed << " ("
+    			 << steady_claimed * 100. / (num_threads * time_steady) << "% of the budget)" << endl;
+    	}
 
     	tEndGeneral = chrono::high_resolution_clock::now();
     	auto duration = chrono::duration_cast<chrono::milliseconds>( tEndGeneral - tStartGeneral ).count();
@@ -582,6 +584,9 @@ void statistics::handleMessage(cMessage *in)
 			if(!dynamic_tc)
 			{
 				delete in;
+				merge_results();
+				dbAk.flush();
+				coord->leave();
 				endSimulation();
 			}
 			else  // *** DYNAMIC TC ***
@@ -601,9 +606,9 @@ void statistics::handleMessage(cMessage *in)
     	    		 */
 
     	    		// We sum the measured cache size of all those nodes that have received traffic.
-    	    		if(cores[i]->interests != 0)
+    	    		if(cores[i]->interests.value() != 0)
     	    		{
-    	    			dbAk << "** Consistency Check on NODE # " << i << endl;
+    	    			DIAG(DIAG_DEBUG, dbAk) << "** Consistency Check on NODE # " << i << endl;
     	    			numActiveNodes++;
     	    			Sum_avg_as_cur += dynamic_cast<ttl_cache*>(caches[i])->avg_as_curr;
 
@@ -628,31 +633,10 @@ void statistics::handleMessage(cMessage *in)
 
     	    	dbAk << "CYCLE " << sim_cycles << " -\tNUM of ACTIVE NODES among the PARTIAL_N NODES: " << numActiveNodes << endl;
 
-    	    	// *** AKAROA *** Send the measured cache size to the Master through the AkObservationMG() function.
-    	    	/*   Param:
-    	    	 *   - paramNum: in this case paramNum = 1 since we are sending the measured cache size.
-    	    	 *   - Sum_avg_as_cur: sum of the measure cache size from all the active nodes.
-    	    	 *   - Sum_target_cache: sum of the target cache (usually  = 10) over all the active nodes.
-    	    	 *   - num_nodes: total number of nodes.
-    	    	 *   - engineWindow: size of the window of samples for each node.
-    	    	 *   - partial_n: actual number of nodes for which the check will be done (usually < numNodes).
-    	    	 *   - pid = process id of the current engine.
-    	    	 *   - num_threads = number of parallel threads which are executing the current simulation.
-    	    	 */
-
-    	    	pid = getpid();
-    	    	paramNum = 1;
-
-    	    	AkObservationMG(1, Sum_avg_as_cur, Sum_target_cache, num_nodes, (int)engineWindow, partial_n, pid, num_threads);
-
-    	    	// Waiting for signal to be received from Master
-    	    	while(!signal_received)
-    	    	{
-    	    		sleep(1);
-    	    	}
-
-    	    	signal_received = false;	// Resetting variable in order to wait for the next signal
-    	    	sleep(1);
+    	    	// Send the sum of the measured and of the target cache sizes over the active nodes
+    	    	// to the Master: the engine blocks until its verdict.
+    	    	stop_simulation = coord->consistent(Sum_avg_as_cur, Sum_target_cache, consThr);
+    	    	steadyState = false;
 
     	    	// The simulation is stopped either the 'STOP' signal has been received from the Master, or
     	    	// there have been already 20 MC-TTL cycles (meaning that something wrong is going on).
@@ -665,20 +649,25 @@ void statistics::handleMessage(cMessage *in)
     	    		dbAk << " *** CACHE MEASUREMENTS at CYCLE # " << sim_cycles << endl;
     	    		for (int i=0; i < num_nodes; i++)
     	    		{
-    	    			dbAk << endl;
-    	    			dbAk << "--- NODE # " << i << " ---" << endl;
-    	    			dbAk << " - Cache ONLINE AVG measured size: " << caches[i]->get_avg_size() << endl;
-    	    			dbAk << " - Cache MAX size: " << caches[i]->get_max_size() << endl;
-    	    			dbAk << " - Cache Tc: " << caches[i]->get_tc() << endl;
+    	    			DIAG(DIAG_DEBUG, dbAk) << endl;
+    	    			DIAG(DIAG_DEBUG, dbAk) << "--- NODE # " << i << " ---" << endl;
+    	    			DIAG(DIAG_DEBUG, dbAk) << " - Cache ONLINE AVG measured size: " << caches[i]->get_avg_size() << endl;
+    	    			DIAG(DIAG_DEBUG, dbAk) << " - Cache MAX size: " << caches[i]->get_max_size() << endl;
+    	    			DIAG(DIAG_DEBUG, dbAk) << " - Cache Tc: " << caches[i]->get_tc() << endl;
     	    			if(caches[i]->check_if_two_ttl())
     	    			{
-    	    				dbAk << "--- Name Cache ---" << endl;
-    	    				dbAk << " - Name Cache ONLINE AVG measured size: " << caches[i]->get_nameCache_avg_size() << endl;
-    	    				dbAk << " - Name Cache Tc: " << caches[i]->get_tc_name() << endl;
+    	    				DIAG(DIAG_DEBUG, dbAk) << "--- Name Cache ---" << endl;
+    	    				DIAG(DIAG_DEBUG, dbAk) << " - Name Cache ONLINE AVG measured size: " << caches[i]->get_nameCache_avg_size() << endl;
+    	    				DIAG(DIAG_DEBUG, dbAk) << " - Name Cache Tc: " << caches[i]->get_tc_name() << endl;
     	    			}
     	    		}
     	    		// **************************
     	    		// END SIMULATION
+    	    		// Local engines: only engine 0 goes on to finish() and records the results
+    	    		// of all of them.
+    	    		merge_results();
+    	    		dbAk.flush();
+    	    		coord->leave();
     	    		endSimulation();
     	    	}
     			else		// Continue the simulation with another MC-TTL cycle.
@@ -688,10 +677,10 @@ void statistics::handleMessage(cMessage *in)
 
     				for (int i=0; i < num_nodes; i++)
     				{
-    					dbAk << "NODE:\t" << i << "\n\tOLD Tc = " << caches[i]->tc_node << "\n";
+    					DIAG(DIAG_DEBUG, dbAk) << "NODE:\t" << i << "\n\tOLD Tc = " << caches[i]->tc_node << "\n";
     					dynamic_cast<ttl_cache*>(caches[i])->extend_sim();			// Set the new Tc
-    					dbAk << "\tNEW Tc = " << caches[i]->tc_node << "\n";
-    					dbAk << "\tOnline Avg Cache Size = " << dynamic_cast<ttl_cache*>(caches[i])->avg_as_curr << "\n";
+    					DIAG(DIAG_DEBUG, dbAk) << "\tNEW Tc = " << caches[i]->tc_node << "\n";
+    					DIAG(DIAG_DEBUG, dbAk) << "\tOnline Avg Cache Size = " << dynamic_cast<ttl_cache*>(caches[i])->avg_as_curr << "\n";
     				}
 
 
@@ -709,15 +698,9 @@ void statistics::handleMessage(cMessage *in)
    					// Clear statistics of the current MC-TTL cycle
    					clear_stat();
 
-   					// Reset sample_counter
-   					for(int i=0; i<num_nodes; i++)
-   					{
-   						sample_counter[i] = 0;
-   					}
-
-   					// Reset the HitMiss vector
-   					for(int i=0; i<sizeVect; i++)
-   						HitMiss[i] = -1;
+   					// The samples of the previous Tc are dropped.
+   					hit_windows.reset();
+   					analysis.clear();
 
    					scheduleAt(simTime() + ts, centralized_stable_check);  // Schedule another centralized stability check.
    					dbAk << "***** Re-SCHEDULE Centralized STABLE CHECK PID:\t" << pid << endl;
@@ -742,100 +725,177 @@ void statistics::handleMessage(cMessage *in)
  */
 void statistics::centralized_stable(int n)
 {
-	// We check if engineWindow samples have already been collected for node n.
-	if(sample_counter[n] != engineWindow)
+	//	Only hit rate matters.
+	uint64_t hit = count(caches[n]->hit), miss = count(caches[n]->miss);
+	uint64_t node_events = count(caches[n]->decision_yes) + hit;
+	if (hit != 0 )
 	{
-		//	Only hit rate matters.
-		if (caches[n]->hit != 0 )
+		// Check if something is changed w.r.t. the previous sample
+		if(node_events != events[n])
 		{
-			// Check if something is changed w.r.t. the previous sample
-			if((caches[n]->decision_yes + caches[n]->hit) != events[n])
-			{
-				// Collect Hit and Miss samples for node 'n' (nodeID 'n' will determine the position in the whole vector
-				HitMiss[(n*(int)engineWindow)+sample_counter[n]] = caches[n]->hit;									// HIT
-				HitMiss[(num_nodes*(int)engineWindow)+(n*(int)engineWindow)+sample_counter[n]] = caches[n]->miss;	// MISS
+			// Collect Hit and Miss samples for node 'n'
+			hit_windows.add(n, hit, miss);
 
-				// Update the number of collected samples for node n
-				sample_counter[n]++;
-
-				// Update number of events
-				events[n] = caches[n]->decision_yes + caches[n]->hit;
-			}
-			//else	// Sample not collected (i.e., the respective values stay to -1)
+			// Update number of events
+			events[n] = node_events;
 		}
-		else
-		// It can be either a node with #Miss=0 (i.e., inactive), or a node which experienced only miss events so far;
-		// in the latter case, we do not collect the sample since we start from the first hit event.
+		//else	// Sample not collected (i.e., the window does not move)
+	}
+	else
+	// It can be either a node with #Miss=0 (i.e., inactive), or a node which experienced only miss events so far;
+	// in the latter case, we do not collect the sample since we start from the first hit event.
+	{
+		if(miss == 0)      	// Inactive node  (we should state it as stable anyway)
 		{
-			if(caches[n]->miss == 0)      	// Inactive node  (we should state it as stable anyway)
-			{
-				HitMiss[(n*(int)engineWindow)+sample_counter[n]] = 0;								// HIT
-				HitMiss[(num_nodes*(int)engineWindow)+(n*(int)engineWindow)+sample_counter[n]] = 0;	// MISS
-
-				// Update the number of collected samples for node n
-				sample_counter[n]++;
-			}
-			else	// Node which has experienced only miss events so far (do not collect sample)
-			{
-				// Update number of events
-				events[n] = caches[n]->decision_yes + caches[n]->hit;
-			}
+			hit_windows.add(n, 0, 0);
+		}
+		else	// Node which has experienced only miss events so far (do not collect sample)
+		{
+			// Update number of events
+			events[n] = node_events;
 		}
 	}
 }
 
 // Print statistics.
+// Layout of the results of an engine (see collect_results()).
+#define RES_HIT			0		// Per node.
+#define RES_MISS		1
+#define RES_INTERESTS	2
+#define RES_DATA		3
+#define RES_REPO_LOAD	4
+#define RES_NODE		5
+#define RES_DISTANCE	0		// Per client, hit distance and download time weighted by the chunks.
+#define RES_TIME		1
+#define RES_CHUNKS		2
+#define RES_DOWNLOADS	3
+#define RES_SENT		4
+#define RES_CLIENT		5
+#define RES_SCHEDULED	0		// Per Shot Noise class.
+#define RES_VALIDATED	1
+#define RES_CLASS		2
+
+/*
+ * 	Final results of the engine: the counters of each node, the statistics of
+ * 	each client and of each Shot Noise class, and the steady time simulated.
+ * 	They are additive, so that the results of several engines are merged by
+ * 	summing them (see merge_results()): the hit ratios are then computed on the
+ * 	counters of all the engines, and the means of the clients are weighted by
+ * 	their chunks, i.e., each engine counts in proportion to the steady time it
+ * 	has simulated.
+ */
+void statistics::collect_results(vector<double> &results)
+{
+	int classes = 0;
+	cModule* pSubModule = getParentModule()->getSubmodule("content_distribution");
+	ShotNoiseContentDistribution* snmPointer = dynamic_cast<ShotNoiseContentDistribution*>(pSubModule);
+	if (snmPointer)
+		classes = snmPointer->numOfClasses;
+
+	results.assign(num_nodes*RES_NODE + num_clients*RES_CLIENT + classes*RES_CLASS + 1, 0);
+	stat_registry::snapshot(counters);
+	for (int i = 0; i < num_nodes; i++)
+	{
+		double *r = &results[i*RES_NODE];
+		r[RES_HIT] = count(caches[i]->hit);
+		r[RES_MISS] = count(caches[i]->miss);
+		r[RES_INTERESTS] = count(cores[i]->interests);
+		r[RES_DATA] = count(cores[i]->data);
+		r[RES_REPO_LOAD] = count(cores[i]->repo_load);
+	}
+	for (int i = 0; i < num_clients; i++)
+	{
+		double *r = &results[num_nodes*RES_NODE + i*RES_CLIENT];
+		double chunks = clients[i]->get_tot_chunks();
+		r[RES_DISTANCE] = clients[i]->get_avg_distance() * chunks;
+		r[RES_TIME] = SIMTIME_DBL(clients[i]->get_avg_time()) * chunks;
+		r[RES_CHUNKS] = chunks;
+		r[RES_DOWNLOADS] = clients[i]->get_tot_downloads();
+		#ifdef SEVERE_DEBUG
+		r[RES_SENT] = clients[i]->get_interests_sent();
+		#endif
+		for (int j = 0; j < classes; j++)
+		{
+			results[num_nodes*RES_NODE + num_clients*RES_CLIENT + j*RES_CLASS + RES_SCHEDULED] += clients[i]->getScheduledReq(j);
+			results[num_nodes*RES_NODE + num_clients*RES_CLIENT + j*RES_CLASS + RES_VALIDATED] += clients[i]->getValidatedReq(j);
+		}
+	}
+	results.back() = budget_chunks > 0 ? steady_claimed : time_steady;
+}
+
+/*
+ * 	With local engines only engine 0 records the results, in finish(): before
+ * 	the engines leave, it collects the sum of the results of all of them.
+ */
+void statistics::merge_results()
+{
+	collect_results(merged_results);
+	if (!coord->reduce(merged_results))
+		merged_results.clear();
+}
+
 void statistics::finish()
 {
 	char name[30];
 
-    uint32_t global_hit = 0;
-    uint32_t global_miss = 0;
-    uint32_t global_interests = 0;
-    uint32_t global_data      = 0;
+    uint64_t global_hit = 0;
+    uint64_t global_miss = 0;
+    uint64_t global_interests = 0;
+    uint64_t global_data      = 0;
     double global_hit_ratio = 0;
 
-    uint32_t global_repo_load = 0;
+    uint64_t global_repo_load = 0;
 	long total_cost = 0;
 
     double global_avg_distance = 0;
-    simtime_t global_avg_time = 0;
+    double global_avg_time = 0;
     uint32_t global_tot_downloads = 0;
 
     #ifdef SEVERE_DEBUG
     unsigned int global_interests_sent = 0;
     #endif
 
+    // Results of all the engines if they have been merged, of this engine otherwise.
+    vector<double> results;
+    if (!merged_results.empty())
+    	results.swap(merged_results);
+    else
+    	collect_results(results);
+
     int active_nodes = 0;
     for (int i = 0; i<num_nodes; i++)
 	{
+    	const double *r = &results[i*RES_NODE];
+
     	//TODO: do not always compute cost. Do it only when you want to evaluate the cost in your network
-		total_cost += cores[i]->repo_load * cores[i]->get_repo_price();
+		total_cost += (uint64_t)r[RES_REPO_LOAD] * cores[i]->get_repo_price();
 
 		// Print measured cache size for each node
-		dbAk << "** CACHE-NODE # " << i << ":\tCACHE = " << dynamic_cast<ttl_cache*>(caches[i])->avg_as_curr << endl;
+		DIAG(DIAG_DEBUG, dbAk) << "** CACHE-NODE # " << i << ":\tCACHE = " << dynamic_cast<ttl_cache*>(caches[i])->avg_as_curr << endl;
 
-		if (cores[i]->interests)	// Check if the considered node has received Interest packets.
+		if (r[RES_INTERESTS] != 0)	// Check if the considered node has received Interest packets.
 		{
+			uint64_t hit = r[RES_HIT], miss = r[RES_MISS];
 			active_nodes++;
-			dbAk << "** NODE # " << i << ":\tHITS = " << caches[i]->hit << "\tMISS = " << caches[i]->miss << endl;
-			global_hit  += caches[i]->hit;
-			global_miss += caches[i]->miss;
-			global_data += cores[i]->data;
-			global_interests += cores[i]->interests;
-			global_repo_load += cores[i]->repo_load;
-			global_hit_ratio += caches[i]->hit * 1./(caches[i]->hit+caches[i]->miss);
+			DIAG(DIAG_DEBUG, dbAk) << "** NODE # " << i << ":\tHITS = " << hit << "\tMISS = " << miss << endl;
+			global_hit  += hit;
+			global_miss += miss;
+			global_data += r[RES_DATA];
+			global_interests += r[RES_INTERESTS];
+			global_repo_load += r[RES_REPO_LOAD];
+			global_hit_ratio += hit * 1./(hit+miss);
 
 			#ifdef SEVERE_DEBUG
-				if (	caches[i]->decision_yes + caches[i]->decision_no +
+				// Counters of this engine.
+				if (	count(caches[i]->decision_yes) + count(caches[i]->decision_no) +
 						(unsigned) cores[i]->unsolicited_data
-						!=  (unsigned) cores[i]->data + cores[i]->repo_load
+						!=  count(cores[i]->data) + count(cores[i]->repo_load)
 				){
 					std::stringstream ermsg;
-					ermsg<<"caches["<<i<<"]->decision_yes="<<caches[i]->decision_yes<<
-						"; caches[i]->decision_no="<<caches[i]->decision_no<<
-						"; cores[i]->data="<<cores[i]->data<<
-						"; cores[i]->repo_load="<<cores[i]->repo_load<<
+					ermsg<<"caches["<<i<<"]->decision_yes="<<count(caches[i]->decision_yes)<<
+						"; caches[i]->decision_no="<<count(caches[i]->decision_no)<<
+						"; cores[i]->data="<<count(cores[i]->data)<<
+						"; cores[i]->repo_load="<<count(cores[i]->repo_load)<<
 						"; cores[i]->unsolicited_data="<<cores[i]->unsolicited_data<<
 						". The sum of "<< "decision_yes and decision_no must be data";
 					severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
@@ -864,7 +924,7 @@ void statistics::finish()
 
     vector<double> global_scheduledReq;
     vector<double> global_validatedReq;
-    ShotNoiseContentDistribution* snmPointer;
+    ShotNoiseContentDistribution* snmPointer = NULL;
 
     // Statistics for popularity classes (only for Shot Noise model)
     cModule* pSubModule = getParentModule()->getSubmodule("content_distribution");
@@ -875,31 +935,45 @@ void statistics::finish()
     	{
     		global_scheduledReq.resize(snmPointer->numOfClasses,0);
     		global_validatedReq.resize(snmPointer->numOfClasses,0);
+    		for(int j=0; j<snmPointer->numOfClasses; j++)
+    		{
+    			global_scheduledReq[j] = results[num_nodes*RES_NODE + num_clients*RES_CLIENT + j*RES_CLASS + RES_SCHEDULED];
+    			global_validatedReq[j] = results[num_nodes*RES_NODE + num_clients*RES_CLIENT + j*RES_CLASS + RES_VALIDATED];
+    		}
     	}
     }
 
 
     for (int i = 0;i<num_clients;i++)
     {
-		global_avg_distance += clients[i]->get_avg_distance();
-		global_tot_downloads += clients[i]->get_tot_downloads();
-		global_avg_time  += clients[i]->get_avg_time();
+    	const double *r = &results[num_nodes*RES_NODE + i*RES_CLIENT];
+    	if (r[RES_CHUNKS] > 0)
+    	{
+    		global_avg_distance += r[RES_DISTANCE] / r[RES_CHUNKS];
+    		global_avg_time += r[RES_TIME] / r[RES_CHUNKS];
+    	}
+		global_tot_downloads += r[RES_DOWNLOADS];
 		//<aa>
 		#ifdef SEVERE_DEBUG
-		global_interests_sent += clients[i]->get_interests_sent();
+		global_interests_sent += r[RES_SENT];
 		#endif
 		//</aa>
+	}
 
+    // Steady time simulated (summed over the engines if their results are merged).
+    double steady_simulated = results.back();
+    sprintf ( name, "steady_time");
+    recordScalar(name, steady_simulated);
 
-		if (snmPointer)
-		{
-			for(int j=0; j<snmPointer->numOfClasses; j++)
-			{
-				global_scheduledReq[j] += clients[i]->getScheduledReq(j);
-				global_validatedReq[j] += clients[i]->getValidatedReq(j);
-			}
-		}
-	}
+    // Confidence interval of the hit ratio over the steady phase of the last MC-TTL cycle.
+    double ci_mean, ci_half_width;
+    if (ci_precision > 0 && analysis.estimate(ci_mean, ci_half_width))
+    {
+    	sprintf ( name, "ci_hit_ratio");
+    	recordScalar(name, ci_mean);
+    	sprintf ( name, "ci_half_width");
+    	recordScalar(name, ci_half_width);
+    }
 
     // Mean hit distance.
     sprintf ( name, "hdistance");
@@ -926,13 +1000,15 @@ void statistics::finish()
     // SNM statistics
     if(snmPointer)
     {
+    	// Requests expected over the steady time simulated.
+    	double expected_requests = snmPointer->totalRequests * steady_simulated / time_steady;
     	for(int j=0; j<snmPointer->numOfClasses; j++)
     	{
     		sprintf(name, "Scheduled_requests_Class_%d", j+1);		// Absolute number of scheduled requests for that class.
     		recordScalar(name, global_scheduledReq[j]);
 
     		sprintf(name, "Scheduled_requests_perc_Class_%d", j+1);		// Percentage of scheduled requests.
-    		recordScalar(name, global_scheduledReq[j] * 1./snmPointer->totalRequests);
+    		recordScalar(name, global_scheduledReq[j] * 1./expected_requests);
 
     		sprintf(name, "Validated_requests_Class_%d", j+1);		// Absolute number of validated requests for that class.
     		recordScalar(name, global_validatedReq[j]);
@@ -941,7 +1017,7 @@ void statistics::finish()
     		recordScalar(name, global_validatedReq[j] * 1./global_scheduledReq[j]);
 
        		sprintf(name, "Validated_requests_abslute_perc_Class_%d", j+1);		// Absolute percentage of validated requests.
-        	recordScalar(name, global_validatedReq[j] * 1./snmPointer->totalRequests);
+        	recordScalar(name, global_validatedReq[j] * 1./expected_requests);
 
     		sprintf(name, "Suppressed_requests_Class_%d", j+1);
     		recordScalar(name, global_scheduledReq[j]-global_validatedReq[j]);
@@ -992,6 +1068,7 @@ void statistics::finish()
 	delete [] caches;
 	delete [] cores;
 	delete [] clients;
+	delete coord;
 
 	// Close debug file used with Akaroa
 	dbAk.close();
@@ -1008,6 +1085,32 @@ void statistics::clear_stat()
 
     for (int i = 0;i<num_nodes;i++)
 	    caches[i]->clear_stat();
+
+    // The next samples of the output analysis start from the cleared counters.
+    fill(analysis_hit.begin(), analysis_hit.end(), 0);
+    fill(analysis_miss.begin(), analysis_miss.end(), 0);
+}
+
+/*
+ * 	Sample the hit ratio of the network (and of each node, if checked) over the
+ * 	last Ts, for the in-engine output analysis, from the last snapshot of the counters.
+ */
+void statistics::sample_hit_ratios()
+{
+	double hits = 0, misses = 0;
+	for (int n = 0; n < num_nodes; n++)
+	{
+		double h = count(caches[n]->hit) - analysis_hit[n];
+		double m = count(caches[n]->miss) - analysis_miss[n];
+		analysis_hit[n] = count(caches[n]->hit);
+		analysis_miss[n] = count(caches[n]->miss);
+		if (analysis.nodes_checked() && h + m > 0)
+			analysis.node(n).add(h / (h + m));
+		hits += h;
+		misses += m;
+	}
+	if (hits + misses > 0)
+		analysis.network().add(hits / (hits + misses));
 }
 
 void statistics::stability_has_been_reached(){
@@ -1256,8 +1359,8 @@ void statistics::cacheFillNaive()
 			pZipf[m] = (double)(num*normConstant);
 		}
 
-		std::random_device rd;     // only used once to initialise (seed) engine
-		std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
+		// Seeded from the run, so that the warm start is reproducible.
+		std::mt19937 rng(philox_rng::module_stream(this)->intRand());
 		std::uniform_int_distribution<uint32_t> uni(1,M); // guaranteed unbiased
 
 		for (uint32_t k=0; k < cSize_targ; k++)
@@ -1502,26 +1605,9 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 	vector<int> repoVector;
 
 
-    int l;
-
     	// Retrieve the Repository storing all the contents
 
-    	repo_t repo = __repo(1);    // The repo is the one associated to the position of the '1' inside the string
-    	l = 0;
-    	while (repo)
-    	{
-    		if (repo & 1)
-			{
- 				//repoVector[m] = content_distribution::repositories[l];  // So far, the replication of seed copies is supposed
-    																    // to be 1 (i.e., the seed copy of each content is stored only in one repo)
-    			//repoVector[m].push_back(content_distribution::repositories[l]);	// In case of more repos stories the seed copies of a content.
-    			repoVector.push_back(content_distribution::repositories[l]);	// In case of more repos stories the seed copies of a content.
- 				//if (m<20)
- 				//	dbAk << "The Repo of content # " << m << " is: " << repoVector[m] << endl;
-    		}
-    		repo >>= 1;
-    		l++;
-    	}
+    	content_distribution::repo_nodes(1, repoVector);
 
 	int outInt;
 	int target;
@@ -1607,7 +1693,7 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 						}
 
 						if (p_hit[neigh][m] > 1)
-							dbAk << "Node: " << n << "\tContent: " << m << "\tNeigh: " << neigh << "\tP_hit: " << p_hit[neigh][m] << endl;
+							DIAG(DIAG_WARN, dbAk) << "Node: " << n << "\tContent: " << m << "\tNeigh: " << neigh << "\tP_hit: " << p_hit[neigh][m] << endl;
 
 						//neigh_rate += (prev_rate[neigh][m]*(1-p_hit[neigh][m]));
 						neigh_rate += (prev_rate[neigh][m]*(1-p_hit[neigh][m]))*(1./numPot);
@@ -1642,10 +1728,10 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 			if (sum_curr_rate != 0) 	// The current node is hit either by exogenous traffic or by miss streams from
 										// other nodes (or by both)
 			{
-				dbAk << "NODE # " << n << " Sum Current Rate: " << sumCurrRate[n] << endl;
+				DIAG(DIAG_DEBUG, dbAk) << "NODE # " << n << " Sum Current Rate: " << sumCurrRate[n] << endl;
 				tc_vect[n] = compute_Tc_single_Approx(cSize_targ, alphaVal, M, curr_rate, n, dpString, q);
 
-				dbAk << "Node # " << n << " - Tc " << tc_vect[n] << endl;
+				DIAG(DIAG_DEBUG, dbAk) << "Node # " << n << " - Tc " << tc_vect[n] << endl;
 				if(meta_cache == LCE)
 				{
 					for(long m=0; m < M; m++)
@@ -1837,12 +1923,12 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 
 
 			pHitTotMean += pHitNodeMean;
-			dbAk << "NODE # " << n << endl;
-			dbAk << "-> Mean Phit: " << pHitNodeMean << endl;
+			DIAG(DIAG_DEBUG, dbAk) << "NODE # " << n << endl;
+			DIAG(DIAG_DEBUG, dbAk) << "-> Mean Phit: " << pHitNodeMean << endl;
 //			dbAk << "-> Steady Cache: Content - Pin - Phit\n";
 //			for (uint32_t k=0; k < cSize_targ; k++)
 //				dbAk << steadyCache[n][k] << " - " << p_in_temp[n][k] << " - " << p_hit_temp[n][k] << endl;
-			dbAk << endl;
+			DIAG(DIAG_DEBUG, dbAk) << endl;
 			pHitNodeMean = 0;
 		}
 	}
@@ -1860,10 +1946,10 @@ void statistics::cacheFillModel_Scalable_Approx(const char* phase)
 	else
 		dbAk << "MODEL - P_HIT MEAN TOTAL AFTER ROUTE re-CALCULATION: " << pHitTotMean << endl;
 
-	dbAk << "*** Tc of nodes ***\n";
+	DIAG(DIAG_DEBUG, dbAk) << "*** Tc of nodes ***\n";
 	for(int n=0; n < N; n++)
 	{
-		dbAk << "Tc-" << n << " --> " << tc_vect[n] << endl;
+		DIAG(DIAG_DEBUG, dbAk) << "Tc-" << n << " --> " << tc_vect[n] << endl;
 	}
 
     // *** DISABLED per perf evaluation
@@ -2404,27 +2490,11 @@ void statistics::cacheFillModel_Scalable_Approx_NRR(const char* phase)
 
 
 
-    int l;
-
     for (long m=0; m < M; m++)		// CONTENTS
     {
     	// Retrieve the Repository storing content 'm'
 
-    	repo_t repo = __repo(m+1);    // The repo is the one associated to the position of the '1' inside the string
-    	l = 0;
-    	while (repo)
-    	{
-    		if (repo & 1)
-			{
- 				//repoVector[m] = content_distribution::repositories[l];  // So far, the replication of seed copies is supposed
-    																    // to be 1 (i.e., the seed copy of each content is stored only in one repo)
-    			repoVector[m].push_back(content_distribution::repositories[l]);	// In case of more repos stories the seed copies of a content.
- 				//if (m<20)
- 				//	dbAk << "The Repo of content # " << m << " is: " << repoVector[m] << endl;
-    		}
-    		repo >>= 1;
-    		l++;
-    	}
+    	content_distribution::repo_nodes(m+1, repoVector[m]);
     }
 
 	int outInt;
@@ -2593,7 +2663,7 @@ void statistics::cacheFillModel_Scalable_Approx_NRR(const char* phase)
 
 
 						if (p_hit[neigh][m] > 1)
-							dbAk << "Node: " << n << "\tContent: " << m << "\tNeigh: " << neigh << "\tP_hit: " << p_hit[neigh][m] << endl;
+							DIAG(DIAG_WARN, dbAk) << "Node: " << n << "\tContent: " << m << "\tNeigh: " << neigh << "\tP_hit: " << p_hit[neigh][m] << endl;
 
 						//neigh_rate += (prev_rate[neigh][m]*(1-p_hit[neigh][m]));
 						neigh_rate += (prev_rate[neigh][m]*(1-p_hit[neigh][m]))*(1./numPot);
@@ -2783,21 +2853,7 @@ void statistics::cacheFillModel_Scalable_Approx_NRR(const char* phase)
 						curr_rate[n][m] = 0;
 						// Clear and re-fill the repo vector with nodes storing seed copies
 						repoVector[m].clear();
-				    	repo_t repo = __repo(m+1);    // The repo is the one associated to the position of the '1' inside the string
-				    	l = 0;
-				    	while (repo)
-				    	{
-				    		if (repo & 1)
-							{
-				 				//repoVector[m] = content_distribution::repositories[l];  // So far, the replication of seed copies is supposed
-				    																    // to be 1 (i.e., the seed copy of each content is stored only in one repo)
-				    			repoVector[m].push_back(content_distribution::repositories[l]);	// In case of more repos stories the seed copies of a content.
-				 				//if (m<20)
-				 				//	dbAk << "The Repo of content # " << m << " is: " << repoVector[m] << endl;
-				    		}
-				    		repo >>= 1;
-				    		l++;
-				    	}
+				    	content_distribution::repo_nodes(m+1, repoVector[m]);
 
 					}
 				}
@@ -2950,12 +3006,12 @@ void statistics::cacheFillModel_Scalable_Approx_NRR(const char* phase)
 
 
 			pHitTotMean += pHitNodeMean;
-			dbAk << "NODE # " << n << endl;
-			dbAk << "-> Mean Phit: " << pHitNodeMean << endl;
+			DIAG(DIAG_DEBUG, dbAk) << "NODE # " << n << endl;
+			DIAG(DIAG_DEBUG, dbAk) << "-> Mean Phit: " << pHitNodeMean << endl;
 //			dbAk << "-> Steady Cache: Content - Pin - Phit\n";
 //			for (uint32_t k=0; k < cSize_targ; k++)
 //				dbAk << steadyCache[n][k] << " - " << p_in_temp[n][k] << " - " << p_hit_temp[n][k] << endl;
-			dbAk << endl;
+			DIAG(DIAG_DEBUG, dbAk) << endl;
 			pHitNodeMean = 0;
 		}
 	}
@@ -2973,10 +3029,10 @@ void statistics::cacheFillModel_Scalable_Approx_NRR(const char* phase)
 	else
 		dbAk << "MODEL - P_HIT MEAN TOTAL AFTER ROUTE re-CALCULATION: " << pHitTotMean << endl;
 
-	dbAk << "*** Tc of nodes ***\n";
+	DIAG(DIAG_DEBUG, dbAk) << "*** Tc of nodes ***\n";
 	for(int n=0; n < N; n++)
 	{
-		dbAk << "Tc-" << n << " --> " << tc_vect[n] << endl;
+		DIAG(DIAG_DEBUG, dbAk) << "Tc-" << n << " --> " << tc_vect[n] << endl;
 	}
 
     // *** DISABLED per perf evaluation
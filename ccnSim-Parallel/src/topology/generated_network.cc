@@ -0,0 +1,189 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "generated_network.h"
+#include "error_handling.h"
+#include <sstream>
+
+Register_Class(generated_network);
+
+
+void generated_network::doBuildInside()
+{
+	topology_generator topo(par("topology_seed").longValue());
+	generate(topo);
+
+	int n = topo.get_num_nodes();
+	const vector<pair<int,int> > &edges = topo.get_edges();
+	cout<<"Generated topology: "<<n<<" nodes, "<<edges.size()<<" links"<<endl;
+
+	// The rest of the simulator reads the size of the network and the placement of
+	// clients and repositories from these parameters, as it does with base_network.
+	par("n").setLongValue(n);
+	set_placement(topo);
+
+	// content_distribution and statistics are declared in the NED file.
+	cModule::doBuildInside();
+
+	cModuleType *node_type = cModuleType::get(full_type_name(par("node_type"),"modules.node").c_str());
+	cModuleType *client_type = cModuleType::get(full_type_name(par("client_type"),"modules.clients").c_str());
+	double delay = par("link_delay").doubleValue();
+
+	// face[0] of each node is the client port, as in base_network; the others
+	// follow the order of the edge list. Gate vectors are sized once.
+	vector<int> degrees = topo.get_degrees();
+	vector<cModule *> nodes(n);
+	vector<cModule *> clients(n);
+	for (int i = 0; i < n; i++){
+		nodes[i] = node_type->create("node", this, n, i);
+		nodes[i]->finalizeParameters();
+		nodes[i]->setGateSize("face", degrees[i]+1);
+
+		clients[i] = client_type->create("client", this, n, i);
+		clients[i]->finalizeParameters();
+
+		connect(nodes[i], "face", 0, clients[i], "client_port", -1, 0);
+	}
+
+	vector<int> next_face(n,1);
+	for (unsigned e = 0; e < edges.size(); e++){
+		int u = edges[e].first;
+		int v = edges[e].second;
+		connect(nodes[u], "face", next_face[u]++, nodes[v], "face", next_face[v]++, delay);
+	}
+
+	for (int i = 0; i < n; i++){
+		nodes[i]->buildInside();
+		clients[i]->buildInside();
+	}
+}
+
+void generated_network::generate(topology_generator &topo)
+{
+	string topology = par("topology").stringValue();
+
+	if (topology == "tree")
+		topo.k_ary_tree(par("arity"), par("depth"), par("extra_link_prob"));
+	else if (topology == "grid")
+		topo.grid(par("rows"), par("cols"), false);
+	else if (topology == "torus")
+		topo.grid(par("rows"), par("cols"), true);
+	else if (topology == "regular")
+		topo.random_regular(par("nodes"), par("degree"));
+	else if (topology == "ba")
+		topo.barabasi_albert(par("nodes"), par("ba_links"));
+	else if (topology == "file")
+		topo.import(par("edge_file"), par("edge_file_format").stringValue());
+	else{
+		std::stringstream ermsg;
+		ermsg<<"Unknown topology "<<topology<<". Valid values are tree, grid, torus, regular, ba, file";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+}
+
+/*
+ * Fill node_clients, num_clients, node_repos and num_repos according to the
+ * client_placement and repo_placement rules, unless the nodes are listed in the
+ * ini file. With the "auto" rule the defaults suggested by the generator are used
+ * (leaves and root of a tree); num_clients=0 then means "all the nodes" if the
+ * generator has no suggestion. With the other rules (see
+ * topology_generator::select_nodes) num_clients and num_repos give the number of
+ * nodes to select; 0 selects all the stub nodes.
+ */
+void generated_network::set_placement(const topology_generator &topo)
+{
+	string client_rule = par("client_placement").stringValue();
+	string repo_rule = par("repo_placement").stringValue();
+
+	if (string(par("node_clients").stringValue()).empty()){
+		vector<int> selected;
+		if (client_rule != "auto")
+			selected = topo.select_nodes(client_rule, par("num_clients"));
+		else if ((int) par("num_clients") == 0){
+			selected = topo.get_default_clients();
+			if (selected.empty())
+				par("num_clients").setLongValue(topo.get_num_nodes());
+		}
+		if (!selected.empty()){
+			par("num_clients").setLongValue(selected.size());
+			par("node_clients").setStringValue(node_list(selected).c_str());
+		}
+	}
+
+	if (string(par("node_repos").stringValue()).empty()){
+		vector<int> selected;
+		if (repo_rule != "auto")
+			selected = topo.select_nodes(repo_rule, par("num_repos"));
+		else{
+			selected = topo.get_default_repos();
+			if ((int) selected.size() > (int) par("num_repos"))
+				selected.resize(par("num_repos").longValue());
+		}
+		if (!selected.empty()){
+			par("num_repos").setLongValue(selected.size());
+			par("node_repos").setStringValue(node_list(selected).c_str());
+		}
+	}
+}
+
+// Comma separated list, as in the node_clients and node_repos parameters.
+string generated_network::node_list(const vector<int> &nodes)
+{
+	std::stringstream list;
+	for (unsigned i = 0; i < nodes.size(); i++)
+		list<<(i ? "," : "")<<nodes[i];
+	return list.str();
+}
+
+// Connect the two inout gates a.a_gate[a_index] and b.b_gate[b_index] (index -1 for
+// scalar gates) with a pair of delay channels.
+void generated_network::connect(cModule *a, const char *a_gate, int a_index,
+		cModule *b, const char *b_gate, int b_index, double delay)
+{
+	string a_base(a_gate), b_base(b_gate);
+
+	cDelayChannel *channel = cDelayChannel::create("channel");
+	channel->setDelay(delay);
+	a->gate((a_base+"$o").c_str(), a_index)->connectTo(b->gate((b_base+"$i").c_str(), b_index), channel);
+
+	channel = cDelayChannel::create("channel");
+	channel->setDelay(delay);
+	b->gate((b_base+"$o").c_str(), b_index)->connectTo(a->gate((a_base+"$i").c_str(), a_index), channel);
+}
+
+// NED types given with their simple name (e.g. client_IRM) are looked up in the
+// default package, as the "like" clause of base_network does.
+string generated_network::full_type_name(const char *type, const char *package)
+{
+	string name(type);
+	if (name.find('.') == string::npos)
+		name = string(package) + "." + name;
+	return name;
+}
@@ -0,0 +1,162 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "network_graph.h"
+#include <cstring>
+#include <thread>
+
+network_graph *network_graph::instance = NULL;
+
+// Dependencies are accumulated in fixed point, so that the result does not
+// depend on the order in which the sources are processed (i.e., on the number
+// of threads).
+#define BTW_SCALE 65536.0
+
+
+network_graph *network_graph::get(cModule *network)
+{
+	if (!instance)
+		instance = new network_graph(network);
+	return instance;
+}
+
+void network_graph::release()
+{
+	delete instance;
+	instance = NULL;
+}
+
+network_graph::network_graph(cModule *network)
+{
+	num_nodes = network->par("n");
+
+	// Faces attached to clients (or left unconnected) are skipped.
+	adj_offset.assign(num_nodes+1, 0);
+	for (int v = 0; v < num_nodes; v++){
+		cModule *node = network->getSubmodule("node", v);
+		int faces = node->gateSize("face");
+		for (int f = 0; f < faces; f++){
+			cGate *next = node->gate("face$o", f)->getNextGate();
+			if (!next)
+				continue;
+			cModule *neighbor = next->getOwnerModule();
+			if (neighbor->getParentModule() != network || strcmp(neighbor->getName(), "node") != 0)
+				continue;
+			adj_node.push_back(neighbor->getIndex());
+			adj_face.push_back(f);
+		}
+		adj_offset[v+1] = adj_node.size();
+	}
+}
+
+const vector<double> &network_graph::get_betweenness(int threads)
+{
+	if (!betweenness.empty())
+		return betweenness;
+
+	if (threads <= 0)
+		threads = max(1u, std::thread::hardware_concurrency());
+	threads = min(threads, num_nodes);
+
+	// Sources are dealt round robin to the threads; each thread has its own
+	// accumulator, merged at the end.
+	vector<vector<unsigned long long> > partial(threads);
+	vector<std::thread> workers;
+	for (int t = 1; t < threads; t++)
+		workers.push_back(std::thread(&network_graph::brandes, this, t, threads, std::ref(partial[t])));
+	brandes(0, threads, partial[0]);
+	for (unsigned t = 0; t < workers.size(); t++)
+		workers[t].join();
+
+	betweenness.assign(num_nodes, 0);
+	for (int v = 0; v < num_nodes; v++){
+		unsigned long long sum = 0;
+		for (int t = 0; t < threads; t++)
+			sum += partial[t][v];
+		// Every shortest path is counted from both its ends.
+		betweenness[v] = sum / BTW_SCALE / 2;
+	}
+	return betweenness;
+}
+
+/*
+ * Brandes' algorithm for the sources first_source, first_source+step, ...
+ * Predecessor lists are not stored: during the back propagation the predecessors
+ * of w are the neighbors one hop closer to the source.
+ */
+void network_graph::brandes(int first_source, int step, vector<unsigned long long> &partial) const
+{
+	partial.assign(num_nodes, 0);
+	vector<int> dist(num_nodes, -1);
+	vector<double> sigma(num_nodes, 0);
+	vector<double> delta(num_nodes, 0);
+	vector<int> order;
+	order.reserve(num_nodes);
+
+	for (int s = first_source; s < num_nodes; s += step){
+		// BFS from s, counting the shortest paths.
+		order.clear();
+		dist[s] = 0;
+		sigma[s] = 1;
+		order.push_back(s);
+		for (unsigned head = 0; head < order.size(); head++){
+			int v = order[head];
+			for (int a = adj_offset[v]; a < adj_offset[v+1]; a++){
+				int w = adj_node[a];
+				if (dist[w] < 0){
+					dist[w] = dist[v] + 1;
+					order.push_back(w);
+				}
+				if (dist[w] == dist[v] + 1)
+					sigma[w] += sigma[v];
+			}
+		}
+
+		// Back propagation of the dependencies, in non increasing distance from s.
+		for (int i = order.size()-1; i > 0; i--){
+			int w = order[i];
+			double coeff = (1 + delta[w]) / sigma[w];
+			for (int a = adj_offset[w]; a < adj_offset[w+1]; a++){
+				int v = adj_node[a];
+				if (dist[v] == dist[w] - 1)
+					delta[v] += sigma[v] * coeff;
+			}
+			partial[w] += (unsigned long long) (delta[w] * BTW_SCALE + 0.5);
+		}
+
+		// Reset only what has been touched.
+		for (unsigned i = 0; i < order.size(); i++){
+			int v = order[i];
+			dist[v] = -1;
+			sigma[v] = 0;
+			delta[v] = 0;
+		}
+	}
+}
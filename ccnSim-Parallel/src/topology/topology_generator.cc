@@ -0,0 +1,456 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "topology_generator.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+topology_generator::topology_generator(unsigned long seed):num_nodes(0),rng(seed){;}
+
+void topology_generator::reset(int nodes)
+{
+	if (nodes <= 0){
+		std::stringstream ermsg;
+		ermsg<<"A topology with "<<nodes<<" nodes cannot be generated";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	clear();
+	num_nodes = nodes;
+}
+
+void topology_generator::clear()
+{
+	num_nodes = 0;
+	edges.clear();
+	edge_set.clear();
+	default_clients.clear();
+	default_repos.clear();
+	label_map.clear();
+	labels.clear();
+}
+
+bool topology_generator::add_edge(int u, int v)
+{
+	if (u == v)
+		return false;
+	unsigned long long key = ((unsigned long long) min(u,v) << 32) | (unsigned) max(u,v);
+	if (!edge_set.insert(key).second)
+		return false;
+	edges.push_back(make_pair(u,v));
+	return true;
+}
+
+vector<int> topology_generator::get_degrees() const
+{
+	vector<int> deg(num_nodes,0);
+	for (unsigned e = 0; e < edges.size(); e++){
+		deg[edges[e].first]++;
+		deg[edges[e].second]++;
+	}
+	return deg;
+}
+
+void topology_generator::k_ary_tree(int arity, int depth, double extra_prob)
+{
+	if (arity < 1 || depth < 0){
+		std::stringstream ermsg;
+		ermsg<<"Invalid tree: arity="<<arity<<", depth="<<depth;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	// Number of nodes up to (and excluding) each level.
+	long long total = 1, level_size = 1, first_leaf = 0;
+	for (int l = 1; l <= depth; l++){
+		first_leaf = total;
+		level_size *= arity;
+		total += level_size;
+	}
+	if (total > (1LL<<31) - 1){
+		std::stringstream ermsg;
+		ermsg<<"A tree with arity "<<arity<<" and depth "<<depth<<" has too many nodes";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	reset((int) total);
+	edges.reserve(total - 1);
+
+	for (int i = 1; i < num_nodes; i++)
+		add_edge((i-1)/arity, i);
+
+	// Extra links between a node and the children of its siblings.
+	if (extra_prob > 0){
+		uniform_real_distribution<double> unif(0.0,1.0);
+		for (int v = 1; v < first_leaf; v++){
+			int parent = (v-1)/arity;
+			for (int s = arity*parent+1; s <= arity*parent+arity; s++){
+				if (s == v)
+					continue;
+				for (int c = arity*s+1; c <= arity*s+arity; c++)
+					if (unif(rng) < extra_prob)
+						add_edge(v,c);
+			}
+		}
+	}
+
+	default_repos.push_back(0);
+	for (int i = (int) first_leaf; i < num_nodes; i++)
+		default_clients.push_back(i);
+}
+
+void topology_generator::grid(int rows, int cols, bool torus)
+{
+	if (rows < 1 || cols < 1){
+		std::stringstream ermsg;
+		ermsg<<"Invalid grid: "<<rows<<"x"<<cols;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	reset(rows*cols);
+	edges.reserve(2*num_nodes);
+
+	for (int r = 0; r < rows; r++)
+		for (int c = 0; c < cols; c++){
+			int v = r*cols + c;
+			if (c+1 < cols)
+				add_edge(v, v+1);
+			else if (torus && cols > 2)
+				add_edge(v, r*cols);
+			if (r+1 < rows)
+				add_edge(v, v+cols);
+			else if (torus && rows > 2)
+				add_edge(v, c);
+		}
+}
+
+void topology_generator::random_regular(int nodes, int degree)
+{
+	if (degree < 1 || degree >= nodes || ((long long) nodes*degree) % 2 != 0){
+		std::stringstream ermsg;
+		ermsg<<"A "<<degree<<"-regular graph with "<<nodes<<" nodes does not exist";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	// Pairing model: free link ends (stubs) are matched at random, discarding self
+	// loops and parallel links. When no valid pair can be found among the remaining
+	// stubs the construction restarts. The expected cost is linear in nodes*degree.
+	const int max_restarts = 100;
+	const int max_tries = 100;
+	vector<int> stubs;
+	for (int attempt = 0; attempt < max_restarts; attempt++){
+		reset(nodes);
+		edges.reserve((size_t) nodes*degree/2);
+		stubs.clear();
+		for (int v = 0; v < nodes; v++)
+			stubs.insert(stubs.end(), degree, v);
+
+		bool stuck = false;
+		while (!stubs.empty() && !stuck){
+			stuck = true;
+			for (int t = 0; t < max_tries; t++){
+				size_t i = uniform_int_distribution<size_t>(0, stubs.size()-1)(rng);
+				size_t j = uniform_int_distribution<size_t>(0, stubs.size()-1)(rng);
+				if (i == j || !add_edge(stubs[i], stubs[j]))
+					continue;
+				// Remove the two stubs (the larger index first).
+				if (i < j) swap(i,j);
+				stubs[i] = stubs.back(); stubs.pop_back();
+				stubs[j] = stubs.back(); stubs.pop_back();
+				stuck = false;
+				break;
+			}
+		}
+		if (!stuck)
+			return;
+	}
+	std::stringstream ermsg;
+	ermsg<<"Unable to generate a "<<degree<<"-regular graph with "<<nodes<<" nodes after "
+		<<max_restarts<<" attempts";
+	severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+}
+
+void topology_generator::barabasi_albert(int nodes, int m)
+{
+	if (m < 1 || nodes <= m){
+		std::stringstream ermsg;
+		ermsg<<"Invalid Barabasi-Albert graph: nodes="<<nodes<<", m="<<m;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	reset(nodes);
+	edges.reserve((size_t) nodes*m);
+
+	// Every node appears in 'ends' once per incident link, so that a uniform
+	// extraction from it is proportional to the degree.
+	vector<int> ends;
+	ends.reserve((size_t) 2*nodes*m);
+	for (int u = 0; u <= m; u++)
+		for (int v = u+1; v <= m; v++){
+			add_edge(u,v);
+			ends.push_back(u);
+			ends.push_back(v);
+		}
+
+	vector<int> targets;
+	for (int v = m+1; v < nodes; v++){
+		targets.clear();
+		while ((int) targets.size() < m){
+			int t = ends[uniform_int_distribution<size_t>(0, ends.size()-1)(rng)];
+			if (find(targets.begin(), targets.end(), t) == targets.end())
+				targets.push_back(t);
+		}
+		for (int k = 0; k < m; k++){
+			add_edge(v, targets[k]);
+			ends.push_back(v);
+			ends.push_back(targets[k]);
+		}
+	}
+}
+
+void topology_generator::open(ifstream &in, const char *file_name)
+{
+	in.open(file_name);
+	if (!in){
+		std::stringstream ermsg;
+		ermsg<<"Unable to open the topology file "<<file_name;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+}
+
+int topology_generator::node_id(const string &label)
+{
+	pair<unordered_map<string,int>::iterator,bool> ins = label_map.insert(make_pair(label, num_nodes));
+	if (ins.second){
+		labels.push_back(label);
+		num_nodes++;
+	}
+	return ins.first->second;
+}
+
+void topology_generator::edge_list(const char *file_name)
+{
+	ifstream in;
+	open(in, file_name);
+
+	vector<pair<int,int> > read_edges;
+	int max_id = -1;
+	string line;
+	unsigned long line_num = 0;
+	while (getline(in,line)){
+		line_num++;
+		size_t first = line.find_first_not_of(" \t\r");
+		if (first == string::npos || line[first] == '#')
+			continue;
+		istringstream fields(line);
+		int u, v;
+		if (!(fields >> u >> v) || u < 0 || v < 0){
+			std::stringstream ermsg;
+			ermsg<<file_name<<":"<<line_num<<": expected two non-negative node ids";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		}
+		read_edges.push_back(make_pair(u,v));
+		max_id = max(max_id, max(u,v));
+	}
+
+	reset(max_id+1);
+	edges.reserve(read_edges.size());
+	for (unsigned e = 0; e < read_edges.size(); e++)
+		add_edge(read_edges[e].first, read_edges[e].second);
+}
+
+void topology_generator::import(const char *file_name, const string &format)
+{
+	if (format == "edges")
+		edge_list(file_name);
+	else if (format == "labels")
+		labelled_edge_list(file_name);
+	else if (format == "graphml")
+		graphml(file_name);
+	else if (format == "rocketfuel")
+		rocketfuel(file_name);
+	else{
+		std::stringstream ermsg;
+		ermsg<<"Unknown topology file format "<<format<<". Valid values are edges, labels, graphml, rocketfuel";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	if (num_nodes == 0){
+		std::stringstream ermsg;
+		ermsg<<"No nodes found in the topology file "<<file_name;
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+}
+
+void topology_generator::labelled_edge_list(const char *file_name)
+{
+	ifstream in;
+	open(in, file_name);
+	clear();
+
+	string line, u, v;
+	unsigned long line_num = 0;
+	while (getline(in,line)){
+		line_num++;
+		size_t first = line.find_first_not_of(" \t\r");
+		if (first == string::npos || line[first] == '#')
+			continue;
+		istringstream fields(line);
+		if (!(fields >> u >> v)){
+			std::stringstream ermsg;
+			ermsg<<file_name<<":"<<line_num<<": expected two node labels";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		}
+		int iu = node_id(u);
+		add_edge(iu, node_id(v));
+	}
+}
+
+// Value of the attribute 'name' inside the text of an XML tag ("" if missing).
+static string xml_attribute(const string &tag, const char *name)
+{
+	string key = string(name) + "=";
+	size_t pos = 0;
+	while ((pos = tag.find(key, pos)) != string::npos){
+		// Make sure that we matched a whole attribute name.
+		if (pos == 0 || isspace((unsigned char) tag[pos-1])){
+			size_t start = pos + key.size();
+			if (start < tag.size() && (tag[start] == '"' || tag[start] == '\'')){
+				size_t end = tag.find(tag[start], start+1);
+				if (end != string::npos)
+					return tag.substr(start+1, end-start-1);
+			}
+		}
+		pos += key.size();
+	}
+	return "";
+}
+
+void topology_generator::graphml(const char *file_name)
+{
+	ifstream in;
+	open(in, file_name);
+	clear();
+
+	// The file is scanned one tag at a time: every chunk ending with '>' contains
+	// (at its end) the text of one tag. Only node and edge elements are used.
+	string chunk;
+	while (getline(in, chunk, '>')){
+		size_t lt = chunk.rfind('<');
+		if (lt == string::npos)
+			continue;
+		string tag = chunk.substr(lt+1);
+		if (tag.compare(0,5,"node ") == 0 || tag.compare(0,5,"node\t") == 0 || tag.compare(0,5,"node\n") == 0)
+			node_id(xml_attribute(tag,"id"));
+		else if (tag.compare(0,5,"edge ") == 0 || tag.compare(0,5,"edge\t") == 0 || tag.compare(0,5,"edge\n") == 0){
+			string source = xml_attribute(tag,"source");
+			string target = xml_attribute(tag,"target");
+			if (source.empty() || target.empty()){
+				std::stringstream ermsg;
+				ermsg<<file_name<<": edge without source or target: <"<<tag<<">";
+				severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+			}
+			int u = node_id(source);
+			add_edge(u, node_id(target));
+		}
+	}
+}
+
+/*
+ * Rocketfuel .cch files describe one router per line:
+ *	uid @loc [+] [bb] (num_neigh) [&ext] -> <nuid-1> <nuid-2> ... {-euid} ... =name[!] rn
+ * Links towards internal routers are the <nuid> fields. Lines of external routers
+ * (negative uid) and the {-euid} fields are ignored.
+ */
+void topology_generator::rocketfuel(const char *file_name)
+{
+	ifstream in;
+	open(in, file_name);
+	clear();
+
+	string line;
+	while (getline(in,line)){
+		istringstream fields(line);
+		string uid;
+		if (!(fields >> uid) || uid[0] == '#' || uid[0] == '-')
+			continue;
+		int u = node_id(uid);
+
+		size_t arrow = line.find("->");
+		if (arrow == string::npos)
+			continue;
+		size_t pos = arrow;
+		while ((pos = line.find('<', pos)) != string::npos){
+			size_t end = line.find('>', pos);
+			if (end == string::npos)
+				break;
+			add_edge(u, node_id(line.substr(pos+1, end-pos-1)));
+			pos = end;
+		}
+	}
+}
+
+vector<int> topology_generator::select_nodes(const string &rule, int count) const
+{
+	vector<int> deg = get_degrees();
+	vector<int> selected;
+
+	if (rule == "stub"){
+		for (int v = 0; v < num_nodes && (count <= 0 || (int) selected.size() < count); v++)
+			if (deg[v] == 1)
+				selected.push_back(v);
+	} else if (rule == "low_degree" || rule == "high_degree"){
+		if (count <= 0 || count > num_nodes){
+			std::stringstream ermsg;
+			ermsg<<"The "<<rule<<" placement needs a number of nodes between 1 and "<<num_nodes
+				<<", while "<<count<<" were requested";
+			severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+		}
+		selected.resize(num_nodes);
+		for (int v = 0; v < num_nodes; v++)
+			selected[v] = v;
+		bool high = (rule == "high_degree");
+		partial_sort(selected.begin(), selected.begin()+count, selected.end(),
+			[&deg,high](int a, int b){
+				if (deg[a] != deg[b])
+					return high ? deg[a] > deg[b] : deg[a] < deg[b];
+				return a < b;
+			});
+		selected.resize(count);
+		sort(selected.begin(), selected.end());
+	} else{
+		std::stringstream ermsg;
+		ermsg<<"Unknown placement rule "<<rule<<". Valid values are auto, stub, low_degree, high_degree";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+
+	if (selected.empty()){
+		std::stringstream ermsg;
+		ermsg<<"The "<<rule<<" placement did not select any node";
+		severe_error(__FILE__,__LINE__,ermsg.str().c_str() );
+	}
+	return selected;
+}
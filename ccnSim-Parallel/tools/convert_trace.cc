@@ -0,0 +1,198 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * convert_trace: converts request logs into the binary request traces replayed
+ * by client_Trace (see include/request_trace.h), and back.
+ *
+ * The input log has one request per line, "time client content", separated by
+ * blanks or commas; empty lines and lines starting with '#' are ignored, and
+ * the requests need not be sorted by time. Contents can be any string (e.g.
+ * URLs): by default they are numbered by decreasing number of requests, so
+ * that 1 is the most popular content as in the Zipf catalogs of ccnSim
+ * (-rank_contents 0 keeps them as they are, and they must then be positive
+ * integers). Clients are node indices, unless -node_clients is given: then the
+ * i-th distinct client of the log is attached to the (i mod K)-th node of the
+ * list.
+ *
+ * Usage:
+ *	convert_trace -in log.txt -out trace.bin [-time_scale 1] [-rank_contents 1]
+ *		[-node_clients 3,5,7]
+ *	convert_trace -dump trace.bin
+ */
+#include "request_trace.h"
+#include <map>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <cstdlib>
+
+using namespace std;
+
+struct log_request{
+	double time;
+	unsigned long client;
+	unsigned long long content;
+};
+
+static vector<int> parse_list(const string &list)
+{
+	vector<int> v;
+	stringstream ss(list);
+	string item;
+	while (getline(ss, item, ','))
+		if (!item.empty())
+			v.push_back(atoi(item.c_str()));
+	return v;
+}
+
+static int dump(const string &path)
+{
+	trace_reader reader;
+	reader.open(path.c_str());
+	trace_record r;
+	cout.precision(9);
+	while (reader.next(r))
+		cout<<fixed<<r.time<<" "<<r.client<<" "<<r.content<<"\n";
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	map<string,string> opt;
+	opt["in"] = "";				opt["out"] = "";			opt["dump"] = "";
+	opt["time_scale"] = "1";	opt["rank_contents"] = "1";	opt["node_clients"] = "";
+
+	for (int i = 1; i < argc; i++){
+		string key(argv[i]);
+		if (key[0] != '-' || i+1 >= argc || opt.find(key.substr(1)) == opt.end()){
+			cerr<<"Unknown or incomplete option "<<key<<" (see the header of convert_trace.cc)"<<endl;
+			return 1;
+		}
+		opt[key.substr(1)] = argv[++i];
+	}
+	if (opt["dump"] != "")
+		return dump(opt["dump"]);
+	if (opt["in"] == "" || opt["out"] == ""){
+		cerr<<"Both -in and -out are needed"<<endl;
+		return 1;
+	}
+
+	ifstream in(opt["in"].c_str());
+	if (!in){
+		cerr<<"Impossible to open "<<opt["in"]<<endl;
+		return 1;
+	}
+	double time_scale = atof(opt["time_scale"].c_str());
+	bool rank = atoi(opt["rank_contents"].c_str()) != 0;
+	vector<int> nodes = parse_list(opt["node_clients"]);
+
+	// Clients and contents are first numbered in order of appearance.
+	unordered_map<string, unsigned long> client_ids, content_ids;
+	vector<unsigned long long> popularity;
+	vector<log_request> requests;
+	string line;
+	unsigned long line_num = 0;
+	while (getline(in, line)){
+		line_num++;
+		replace(line.begin(), line.end(), ',', ' ');
+		stringstream ss(line);
+		string time, client, content;
+		if (!(ss>>time) || time[0] == '#')
+			continue;
+		if (!(ss>>client>>content)){
+			cerr<<opt["in"]<<":"<<line_num<<": expected \"time client content\""<<endl;
+			return 1;
+		}
+		log_request r;
+		r.time = atof(time.c_str()) * time_scale;
+
+		if (nodes.empty())
+			r.client = strtoul(client.c_str(), NULL, 10);
+		else{
+			unordered_map<string, unsigned long>::iterator c = client_ids.find(client);
+			if (c == client_ids.end())
+				c = client_ids.insert(make_pair(client, client_ids.size())).first;
+			r.client = nodes[c->second % nodes.size()];
+		}
+
+		if (rank){
+			unordered_map<string, unsigned long>::iterator c = content_ids.find(content);
+			if (c == content_ids.end()){
+				c = content_ids.insert(make_pair(content, content_ids.size())).first;
+				popularity.push_back(0);
+			}
+			popularity[c->second]++;
+			r.content = c->second;
+		} else{
+			r.content = strtoull(content.c_str(), NULL, 10);
+			if (r.content == 0){
+				cerr<<opt["in"]<<":"<<line_num<<": contents are numbered from 1"<<endl;
+				return 1;
+			}
+		}
+		requests.push_back(r);
+	}
+
+	if (rank){
+		// Rename the contents by decreasing popularity (ties in order of appearance).
+		vector<unsigned long> order(popularity.size());
+		for (unsigned long i = 0; i < order.size(); i++)
+			order[i] = i;
+		stable_sort(order.begin(), order.end(),
+			[&popularity](unsigned long a, unsigned long b){return popularity[a] > popularity[b];});
+		vector<unsigned long long> new_id(order.size());
+		for (unsigned long i = 0; i < order.size(); i++)
+			new_id[order[i]] = i + 1;
+		for (size_t i = 0; i < requests.size(); i++)
+			requests[i].content = new_id[requests[i].content];
+	}
+
+	stable_sort(requests.begin(), requests.end(),
+		[](const log_request &a, const log_request &b){return a.time < b.time;});
+
+	trace_writer writer;
+	writer.open(opt["out"].c_str());
+	for (size_t i = 0; i < requests.size(); i++)
+		writer.append(requests[i].time, requests[i].client, requests[i].content);
+	writer.close();
+
+	cout<<requests.size()<<" requests";
+	if (rank)
+		cout<<" for "<<popularity.size()<<" contents";
+	if (!nodes.empty())
+		cout<<" of "<<client_ids.size()<<" clients";
+	cout<<" written to "<<opt["out"]<<endl;
+	return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * coordinator_daemon: master of the parallel ModelGraft for the engines that
+ * use **.coordinator = "socket" (see include/coordinator.h). It applies the
+ * same rules as the local engines (stability_master, master_consistent) to
+ * the observations of all the engines, and sends the verdict to each of them.
+ *
+ * The engines are independent ccnSim processes with the same configuration
+ * (num_threads = number of engines, rng-class = "philox_rng") and the same
+ * coordinator_socket; they get their index in order of connection. The budget
+ * of the steady phase (statistics budget_chunks) is handed out in the order of
+ * the claims.
+ *
+ * Usage:
+ *	coordinator_daemon -socket /tmp/ccnsim.sock -engines 4 [-runs 1]
+ */
+#include "coordinator.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+static void fail(const string &what)
+{
+	cerr<<"coordinator_daemon: "<<what<<endl;
+	exit(1);
+}
+
+/*
+ * One run: the engines send the same sequence of round requests, and each
+ * round is answered once all the engines have sent their request. The claims
+ * of the budget of the steady phase are answered at once.
+ */
+static void serve_run(int listener, int engines)
+{
+	vector<int> fds(engines);
+	for (int e = 0; e < engines; e++)
+	{
+		fds[e] = accept(listener, NULL, NULL);
+		if (fds[e] < 0)
+			fail(string("accept: ") + strerror(errno));
+	}
+
+	vector<coord_request> req(engines);
+	vector<bool> waiting(engines, false);
+	int num_waiting = 0;
+	vector<node_summary> records;
+	stability_master master;
+	double budget = 0, budget_left = 0;
+	vector<double> claimed(engines, 0);
+	vector<struct pollfd> polled(engines);
+
+	for (int round = 0; ; )
+	{
+		for (int e = 0; e < engines; e++)
+		{
+			polled[e].fd = fds[e];
+			polled[e].events = POLLIN;
+			polled[e].revents = 0;
+		}
+		if (poll(&polled[0], engines, -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			fail(string("poll: ") + strerror(errno));
+		}
+
+		for (int e = 0; e < engines; e++)
+		{
+			if (polled[e].revents == 0)
+				continue;
+			if (waiting[e])
+				fail("engine " + to_string(e) + " is out of step");
+			coord_request &r = req[e];
+			if (!read_all(fds[e], &r, sizeof(coord_request)))
+				fail("engine " + to_string(e) + " disconnected");
+
+			if (r.type == COORD_CLAIM)
+			{
+				coord_reply reply;
+				reply.verdict = 0;
+				reply.value = 0;
+				reply.amount = max(0.0, min(r.amount, budget_left));
+				budget_left -= reply.amount;
+				claimed[e] += reply.amount;
+				if (!write_all(fds[e], &reply, sizeof(reply)))
+					fail("engine " + to_string(e) + " disconnected");
+				continue;
+			}
+			if (r.type == COORD_STABLE)
+			{
+				records.resize(r.records);
+				if (r.records > 0 && !read_all(fds[e], &records[0], records.size()*sizeof(node_summary)))
+					fail("engine " + to_string(e) + " disconnected");
+				if (!master.update(e, records.empty() ? NULL : &records[0], records.size()))
+					fail("engine " + to_string(e) + " sent an unknown node");
+			}
+			waiting[e] = true;
+			num_waiting++;
+		}
+		if (num_waiting < engines)
+			continue;
+
+		for (int e = 0; e < engines; e++)
+		{
+			if (req[e].type != req[0].type)
+				fail("engine " + to_string(e) + " is out of step");
+			if (req[e].num_nodes != req[0].num_nodes || req[e].window != req[0].window)
+				fail("engine " + to_string(e) + " has different windows");
+		}
+
+		coord_reply reply;
+		reply.verdict = 0;
+		reply.value = 0;
+		reply.amount = 0;
+		const coord_request &r = req[0];
+		if (r.type == COORD_HELLO)
+		{
+			master.init(engines, r.num_nodes, r.window);
+			budget = budget_left = r.amount;
+		}
+		else if (r.type == COORD_STABLE)
+		{
+			int with_traffic;
+			reply.value = master.stable_nodes(r.threshold, with_traffic);
+			reply.verdict = master_stable(reply.value, with_traffic, r.partial_n);
+			cout<<"round "<<round<<": "<<reply.value<<" stable nodes ("<<with_traffic<<" with traffic)"<<(reply.verdict ? " -> STABLE" : "")<<endl;
+		}
+		else if (r.type == COORD_CONSISTENT)
+		{
+			double measured = 0, target = 0;
+			for (int e = 0; e < engines; e++)
+			{
+				measured += req[e].measured;
+				target += req[e].target;
+			}
+			reply.verdict = master_consistent(measured, target, r.threshold);
+			cout<<"round "<<round<<": cache size "<<measured<<" / "<<target<<(reply.verdict ? " -> STOP" : " -> NEW CYCLE")<<endl;
+			if (budget > 0)
+			{
+				cout<<"\tsteady phase per engine:";
+				for (int e = 0; e < engines; e++)
+					cout<<" "<<claimed[e];
+				cout<<endl;
+			}
+			budget_left = budget;
+			fill(claimed.begin(), claimed.end(), 0);
+		}
+
+		for (int e = 0; e < engines; e++)
+		{
+			if (r.type == COORD_HELLO)
+				reply.value = e;
+			if (!write_all(fds[e], &reply, sizeof(reply)))
+				fail("engine " + to_string(e) + " disconnected");
+			waiting[e] = false;
+		}
+		num_waiting = 0;
+		round++;
+		if (r.type == COORD_BYE)
+			break;
+	}
+	for (int e = 0; e < engines; e++)
+		close(fds[e]);
+}
+
+int main(int argc, char **argv)
+{
+	map<string,string> opt;
+	opt["socket"] = "";		opt["engines"] = "";	opt["runs"] = "1";
+
+	for (int i = 1; i < argc; i++)
+	{
+		string key(argv[i]);
+		if (key[0] != '-' || i+1 >= argc || opt.find(key.substr(1)) == opt.end())
+		{
+			cerr<<"Unknown or incomplete option "<<key<<" (see the header of coordinator_daemon.cc)"<<endl;
+			return 1;
+		}
+		opt[key.substr(1)] = argv[++i];
+	}
+	int engines = atoi(opt["engines"].c_str());
+	int runs = atoi(opt["runs"].c_str());
+	if (opt["socket"] == "" || engines < 1)
+	{
+		cerr<<"Both -socket and -engines are needed"<<endl;
+		return 1;
+	}
+
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (opt["socket"].size() >= sizeof(addr.sun_path))
+		fail("socket path too long");
+	strcpy(addr.sun_path, opt["socket"].c_str());
+
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(addr.sun_path);
+	if (listener < 0 || bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, engines) != 0)
+		fail(opt["socket"] + ": " + strerror(errno));
+
+	for (int run = 0; run < runs; run++)
+	{
+		serve_run(listener, engines);
+		cout<<"run "<<run<<" completed"<<endl;
+	}
+	close(listener);
+	unlink(addr.sun_path);
+	return 0;
+}
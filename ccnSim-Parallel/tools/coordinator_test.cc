@@ -0,0 +1,476 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * coordinator_test: runs fake engines through the coordinators of the
+ * parallel ModelGraft that do not need Akaroa (see include/coordinator.h), and
+ * checks that they reach the same decisions as a master that sees the
+ * observations of all the engines in a single process:
+ *	- local:	the engines are forked by engine_pool;
+ *	- socket:	the engines are separate processes connected to
+ *				coordinator_daemon (started by the test).
+ *
+ * Each fake engine feeds the stability windows of its nodes with synthetic
+ * hit and miss counts (a transient that fades out, plus noise drawn from the
+ * engine index, some nodes without traffic at the beginning and, with -quiet,
+ * some nodes without traffic during the whole run), asks for the
+ * stable verdict until the transient is over, claims chunks of the steady
+ * budget, then asks for the consistency verdict with synthetic cache sizes
+ * that converge over the MC-TTL cycles. The checks are:
+ *	- the verdict and the number of stable nodes of every stable round;
+ *	- the verdict of every consistency round;
+ *	- the budget claimed by all the engines in each cycle (and that no engine
+ *	  was granted more than a chunk at a time);
+ *	- the results summed by reduce() (local engines only).
+ *
+ * Usage:
+ *	coordinator_test [-mode local|socket|both] [-engines 4] [-nodes 40]
+ *		[-window 20] [-chunks 10] [-partial_n 0.9] [-quiet 0]
+ *		[-daemon ./coordinator_daemon]
+ * (to be launched from the tools directory)
+ */
+#include "coordinator.h"
+#include "engine_pool.h"
+#include "socket_coordinator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+#define MAX_ROUNDS 256
+#define MAX_CYCLES 16
+#define TEST_CV_THR 0.05
+#define TEST_CONS_THR 0.05
+#define TEST_STEADY 100.0		// Steady time of each engine.
+
+struct scenario{
+	int engines;
+	int nodes;
+	int window;
+	int partial_n;
+	int chunks;					// 0: fixed steady phase per engine.
+	int step;					// Samples per node between two stable rounds.
+	int quiet;					// Nodes without traffic during the whole run.
+};
+
+// Decisions of an engine, on a MAP_SHARED segment.
+struct engine_report{
+	int rounds;
+	int stables[MAX_ROUNDS];
+	char stable_verdict[MAX_ROUNDS];
+	int cycles;
+	char consistent_verdict[MAX_CYCLES];
+	double claimed[MAX_CYCLES];
+	double largest_claim;
+	double reduced[3];
+	int reduced_valid;
+	int done;
+};
+
+static uint64_t mix(uint64_t x)
+{
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+static double unit(uint64_t x)
+{
+	return ((x >> 11) + 0.5) * (1.0/9007199254740992.0);
+}
+
+/*
+ * Hit and miss counts of the t-th sample of 'node' on engine 'e': the hit
+ * ratio converges to a value of the node, with a transient that fades out and
+ * noise; the nodes n = 4 mod 5 have no traffic in the first two windows, the
+ * last 'quiet' nodes none at all.
+ */
+static void sample(const scenario &s, int e, int node, int t, int64_t &hit, int64_t &miss)
+{
+	if ((node % 5 == 4 && t < 2*s.window) || node >= s.nodes - s.quiet)
+	{
+		hit = miss = 0;
+		return;
+	}
+	const int requests = 400;
+	double p = 0.2 + 0.6*node/s.nodes;
+	double transient = 0.6*exp(-t/(0.75*s.window));
+	double noise = (unit(mix(((uint64_t)e << 48) ^ ((uint64_t)node << 24) ^ (uint64_t)t)) - 0.5)*0.02;
+	double x = min(1.0, max(0.0, p*(1 - transient) + noise));
+	hit = llround(x*requests);
+	miss = requests - hit;
+}
+
+// Measured and target cache sizes of engine 'e' at the end of a cycle.
+static void cache_sizes(int e, int cycle, double &measured, double &target)
+{
+	target = 100.0*(e + 1);
+	measured = target*(1 + (e % 2 ? 0.6 : -0.2)/((cycle + 1)*(cycle + 1)));
+}
+
+/*
+ * The engines all in one process, with one master: the decisions the
+ * coordinators must reproduce.
+ */
+static void reference(const scenario &s, engine_report &ref)
+{
+	memset(&ref, 0, sizeof(ref));
+	vector<stability_window> windows(s.engines);
+	for (int e = 0; e < s.engines; e++)
+		windows[e].init(s.nodes, s.window);
+	stability_master master;
+	master.init(s.engines, s.nodes, s.window);
+	vector<node_summary> changes;
+
+	int t = 0;
+	for (int cycle = 0; cycle < MAX_CYCLES; cycle++)
+	{
+		bool stable = false;
+		while (!stable && ref.rounds < MAX_ROUNDS)
+		{
+			for (int k = 0; k < s.step; k++, t++)
+				for (int e = 0; e < s.engines; e++)
+					for (int n = 0; n < s.nodes; n++)
+					{
+						int64_t hit, miss;
+						sample(s, e, n, t, hit, miss);
+						windows[e].add(n, hit, miss);
+					}
+			for (int e = 0; e < s.engines; e++)
+			{
+				changes.clear();
+				windows[e].take_changes(changes);
+				master.update(e, changes.empty() ? NULL : &changes[0], changes.size());
+			}
+			int with_traffic;
+			ref.stables[ref.rounds] = master.stable_nodes(TEST_CV_THR, with_traffic);
+			stable = master_stable(ref.stables[ref.rounds], with_traffic, s.partial_n);
+			ref.stable_verdict[ref.rounds++] = stable;
+		}
+
+		double measured = 0, target = 0;
+		for (int e = 0; e < s.engines; e++)
+		{
+			double m, tg;
+			cache_sizes(e, cycle, m, tg);
+			measured += m;
+			target += tg;
+		}
+		ref.claimed[cycle] = s.engines*TEST_STEADY;
+		ref.consistent_verdict[cycle] = master_consistent(measured, target, TEST_CONS_THR);
+		ref.cycles = cycle + 1;
+		if (ref.consistent_verdict[cycle])
+			break;
+		for (int e = 0; e < s.engines; e++)
+			windows[e].reset();
+	}
+	ref.reduced[0] = s.engines;
+	ref.reduced[1] = s.engines*(s.engines - 1)/2.0;
+	ref.reduced[2] = s.engines*TEST_STEADY*ref.cycles;
+	ref.done = 1;
+}
+
+/*
+ * One fake engine on coordinator 'c', as statistics drives it.
+ */
+static void run_engine(const scenario &s, coordinator &c, engine_report *reports)
+{
+	if (s.chunks > 0)
+		c.set_budget(s.engines*TEST_STEADY);
+	c.set_results(3);
+	int e = c.start(s.engines, s.nodes, s.window, s.partial_n);
+	engine_report &r = reports[e];
+
+	stability_window windows;
+	windows.init(s.nodes, s.window);
+	double claimed_total = 0;
+	int t = 0;
+	for (int cycle = 0; cycle < MAX_CYCLES; cycle++)
+	{
+		bool stable = false;
+		while (!stable && r.rounds < MAX_ROUNDS)
+		{
+			for (int k = 0; k < s.step; k++, t++)
+				for (int n = 0; n < s.nodes; n++)
+				{
+					int64_t hit, miss;
+					sample(s, e, n, t, hit, miss);
+					windows.add(n, hit, miss);
+				}
+			stable = c.stable(windows, TEST_CV_THR);
+			r.stables[r.rounds] = c.stable_nodes();
+			r.stable_verdict[r.rounds++] = stable;
+		}
+
+		// Steady phase: the engines with a higher index are slower, so that
+		// the faster ones claim more of the budget.
+		double claimed = 0;
+		if (s.chunks > 0)
+		{
+			double chunk;
+			while ((chunk = c.claim(TEST_STEADY/s.chunks)) > 0)
+			{
+				claimed += chunk;
+				r.largest_claim = max(r.largest_claim, chunk);
+				usleep(200*(e + 1));
+			}
+		}
+		else
+			claimed = TEST_STEADY;
+		r.claimed[cycle] = claimed;
+		claimed_total += claimed;
+
+		double measured, target;
+		cache_sizes(e, cycle, measured, target);
+		r.consistent_verdict[cycle] = c.consistent(measured, target, TEST_CONS_THR);
+		r.cycles = cycle + 1;
+		if (r.consistent_verdict[cycle])
+			break;
+		windows.reset();
+	}
+
+	vector<double> results(3);
+	results[0] = 1;
+	results[1] = e;
+	results[2] = claimed_total;
+	if (c.reduce(results))
+	{
+		r.reduced_valid = 1;
+		copy(results.begin(), results.end(), r.reduced);
+	}
+	r.done = 1;
+	c.leave();
+}
+
+static int check(const scenario &s, const char *mode, const engine_report &ref, const engine_report *reports, bool merged)
+{
+	int errors = 0;
+	for (int e = 0; e < s.engines; e++)
+	{
+		const engine_report &r = reports[e];
+		if (!r.done)
+		{
+			cout<<mode<<": engine "<<e<<" did not complete"<<endl;
+			errors++;
+			continue;
+		}
+		if (r.rounds != ref.rounds || r.cycles != ref.cycles)
+		{
+			cout<<mode<<": engine "<<e<<" ran "<<r.rounds<<" stable rounds and "<<r.cycles<<" cycles instead of "
+				<<ref.rounds<<" and "<<ref.cycles<<endl;
+			errors++;
+			continue;
+		}
+		for (int k = 0; k < ref.rounds; k++)
+			if (r.stables[k] != ref.stables[k] || r.stable_verdict[k] != ref.stable_verdict[k])
+			{
+				cout<<mode<<": engine "<<e<<", stable round "<<k<<": "<<r.stables[k]<<" stable nodes instead of "<<ref.stables[k]<<endl;
+				errors++;
+			}
+		for (int k = 0; k < ref.cycles; k++)
+			if (r.consistent_verdict[k] != ref.consistent_verdict[k])
+			{
+				cout<<mode<<": engine "<<e<<", consistency round "<<k<<": wrong verdict"<<endl;
+				errors++;
+			}
+		if (s.chunks > 0 && r.largest_claim > TEST_STEADY/s.chunks + 1e-9)
+		{
+			cout<<mode<<": engine "<<e<<" was granted "<<r.largest_claim<<" at once"<<endl;
+			errors++;
+		}
+	}
+	for (int k = 0; k < ref.cycles && errors == 0; k++)
+	{
+		double claimed = 0;
+		for (int e = 0; e < s.engines; e++)
+			claimed += reports[e].claimed[k];
+		if (fabs(claimed - ref.claimed[k]) > 1e-6*ref.claimed[k])
+		{
+			cout<<mode<<": cycle "<<k<<": "<<claimed<<" of the steady phase claimed instead of "<<ref.claimed[k]<<endl;
+			errors++;
+		}
+	}
+	if (merged && errors == 0)
+	{
+		if (!reports[0].reduced_valid)
+		{
+			cout<<mode<<": the results were not merged"<<endl;
+			errors++;
+		}
+		else
+			for (int i = 0; i < 3; i++)
+				if (fabs(reports[0].reduced[i] - ref.reduced[i]) > 1e-6*max(1.0, ref.reduced[i]))
+				{
+					cout<<mode<<": merged result "<<i<<" is "<<reports[0].reduced[i]<<" instead of "<<ref.reduced[i]<<endl;
+					errors++;
+				}
+	}
+
+	cout<<mode<<": "<<s.engines<<" engines, "<<ref.rounds<<" stable rounds ("<<ref.stables[ref.rounds-1]
+		<<" stable nodes at the last one), "<<ref.cycles<<" cycles, budget_chunks = "<<s.chunks;
+	if (s.chunks > 0)
+	{
+		cout<<", last cycle claimed:";
+		for (int e = 0; e < s.engines; e++)
+			cout<<" "<<reports[e].claimed[ref.cycles-1];
+	}
+	cout<<(errors ? " -> FAILED" : " -> OK")<<endl;
+	return errors;
+}
+
+static engine_report *shared_reports(int engines)
+{
+	void *p = mmap(NULL, engines*sizeof(engine_report), PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+	{
+		cerr<<"coordinator_test: cannot map the reports"<<endl;
+		exit(1);
+	}
+	memset(p, 0, engines*sizeof(engine_report));
+	return (engine_report *)p;
+}
+
+static int test_local(const scenario &s, const engine_report &ref)
+{
+	engine_report *reports = shared_reports(s.engines);
+	{
+		engine_pool pool;
+		run_engine(s, pool, reports);		// The other engines exit in leave().
+	}
+	int errors = check(s, "local", ref, reports, true);
+	munmap(reports, s.engines*sizeof(engine_report));
+	return errors;
+}
+
+static int test_socket(const scenario &s, const engine_report &ref, const string &daemon)
+{
+	string path = "/tmp/coordinator_test_" + to_string(getpid()) + ".sock";
+	string engines = to_string(s.engines);
+	pid_t daemon_pid = fork();
+	if (daemon_pid == 0)
+	{
+		if (!freopen("/dev/null", "w", stdout))
+			_exit(1);
+		execl(daemon.c_str(), daemon.c_str(), "-socket", path.c_str(), "-engines", engines.c_str(), (char *)NULL);
+		_exit(127);
+	}
+
+	engine_report *reports = shared_reports(s.engines);
+	vector<pid_t> pids;
+	for (int e = 0; e < s.engines; e++)
+	{
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			socket_coordinator c(path);
+			run_engine(s, c, reports);
+			_exit(0);
+		}
+		pids.push_back(pid);
+	}
+	int errors = 0;
+	for (size_t i = 0; i < pids.size(); i++)
+	{
+		int status;
+		waitpid(pids[i], &status, 0);
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			errors++;
+	}
+	int status;
+	waitpid(daemon_pid, &status, 0);
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+	{
+		cout<<"socket: "<<daemon<<" failed (exit status "<<WEXITSTATUS(status)<<")"<<endl;
+		errors++;
+	}
+	errors += check(s, "socket", ref, reports, false);
+	munmap(reports, s.engines*sizeof(engine_report));
+	return errors;
+}
+
+int main(int argc, char **argv)
+{
+	map<string,string> opt;
+	opt["mode"] = "both";	opt["engines"] = "4";	opt["nodes"] = "40";
+	opt["window"] = "20";	opt["chunks"] = "10";	opt["daemon"] = "./coordinator_daemon";
+	opt["partial_n"] = "0.9";	opt["quiet"] = "0";
+
+	for (int i = 1; i < argc; i++)
+	{
+		string key(argv[i]);
+		if (key[0] != '-' || i+1 >= argc || opt.find(key.substr(1)) == opt.end())
+		{
+			cerr<<"Unknown or incomplete option "<<key<<" (see the header of coordinator_test.cc)"<<endl;
+			return 1;
+		}
+		opt[key.substr(1)] = argv[++i];
+	}
+
+	scenario s;
+	s.engines = atoi(opt["engines"].c_str());
+	s.nodes = atoi(opt["nodes"].c_str());
+	s.window = atoi(opt["window"].c_str());
+	s.chunks = atoi(opt["chunks"].c_str());
+	s.partial_n = (int)round(atof(opt["partial_n"].c_str())*s.nodes);
+	s.quiet = atoi(opt["quiet"].c_str());
+	s.step = max(1, s.window/4);
+	if (s.engines < 1 || s.nodes < 1 || s.window < 1 || s.chunks < 0 || s.quiet < 0 || s.quiet > s.nodes)
+	{
+		cerr<<"Invalid scenario"<<endl;
+		return 1;
+	}
+
+	engine_report ref;
+	reference(s, ref);
+	if (!ref.stable_verdict[ref.rounds-1] || !ref.consistent_verdict[ref.cycles-1])
+	{
+		cerr<<"The reference run does not converge: change the scenario"<<endl;
+		return 1;
+	}
+
+	int errors = 0;
+	if (opt["mode"] == "local" || opt["mode"] == "both")
+		errors += test_local(s, ref);
+	if (opt["mode"] == "socket" || opt["mode"] == "both")
+		errors += test_socket(s, ref, opt["daemon"]);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * ccnSim is a scalable chunk-level simulator for Content Centric
+ * Networks (CCN), that we developed in the context of ANR Connect
+ * (http://www.anr-connect.org/)
+ *
+ * People:
+ *    Giuseppe Rossini (Former lead developer, mailto giuseppe.rossini@enst.fr)
+ *    Raffaele Chiocchetti (Former developer, mailto raffaele.chiocchetti@gmail.com)
+ *    Andrea Araldo (Principal suspect 1.0, mailto araldo@lri.fr)
+ *    Michele Tortelli (Principal suspect 1.1, mailto michele.tortelli@telecom-paristech.fr)
+ *    Dario Rossi (Occasional debugger, mailto dario.rossi@enst.fr)
+ *    Emilio Leonardi (Well informed outsider, mailto emilio.leonardi@tlc.polito.it)
+ *
+ * Mailing list: 
+ *    ccnsim@listes.telecom-paristech.fr
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ * 
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * query_results: reads the binary columnar result files written by
+ * column_scalar_manager (see include/result_store.h).
+ *
+ * Without -merge and -list, the values of the selected scalars are aggregated
+ * over all the files and printed as tab-separated lines: the grouping keys,
+ * then count, mean, stddev, min, max and sum. Scalars are selected by metric
+ * (exact name, e.g. p_hit), run and module (substrings) and node index; -by
+ * lists the keys to group by, among run, module, node and metric (default
+ * metric). Only the blocks that may hold the selected metric and runs are
+ * read.
+ *
+ * -merge writes all the rows of the input files into one file, e.g. to join
+ * the files of the engines of a job. The files can also be listed, one per
+ * line, in the file given with -files.
+ *
+ * Usage:
+ *	query_results [-metric p_hit] [-run Akaroa] [-module node] [-node 3]
+ *		[-by run,metric] [-files list.txt] file.ccr ...
+ *	query_results -merge all.ccr file.ccr ...
+ *	query_results -list 1 file.ccr ...
+ */
+#include "result_store.h"
+#include <map>
+#include <array>
+#include <cmath>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+enum group_key {BY_RUN, BY_MODULE, BY_NODE, BY_METRIC, NUM_KEYS};
+static const char *key_names[NUM_KEYS] = {"run", "module", "node", "metric"};
+
+// Count, mean and M2 of a group (merged with Chan's formula), min, max, sum.
+struct aggregate{
+	uint64_t count;
+	double mean, m2, min, max, sum;
+
+	aggregate():count(0),mean(0),m2(0),min(INFINITY),max(-INFINITY),sum(0){;}
+
+	void add(double x)
+	{
+		count++;
+		double delta = x - mean;
+		mean += delta/count;
+		m2 += delta*(x - mean);
+		min = std::min(min, x);
+		max = std::max(max, x);
+		sum += x;
+	}
+
+	void merge(const aggregate &o)
+	{
+		if (o.count == 0)
+			return;
+		uint64_t n = count + o.count;
+		double delta = o.mean - mean;
+		m2 += o.m2 + delta*delta*count*o.count/n;
+		mean += delta*o.count/n;
+		count = n;
+		min = std::min(min, o.min);
+		max = std::max(max, o.max);
+		sum += o.sum;
+	}
+};
+
+static vector<string> split(const string &list)
+{
+	vector<string> v;
+	stringstream ss(list);
+	string item;
+	while (getline(ss, item, ','))
+		if (!item.empty())
+			v.push_back(item);
+	return v;
+}
+
+// Ids of the dictionary entries containing 'pattern' (all if empty).
+static vector<char> matching(const result_dictionary &dict, const string &pattern)
+{
+	vector<char> match(dict.size(), 1);
+	if (!pattern.empty())
+		for (uint32_t i = 0; i < dict.size(); i++)
+			match[i] = dict.name(i).find(pattern) != string::npos;
+	return match;
+}
+
+static bool any_in(const vector<char> &match, uint32_t from, uint32_t to)
+{
+	for (uint32_t i = from; i <= to && i < match.size(); i++)
+		if (match[i])
+			return true;
+	return false;
+}
+
+static int list(const vector<string> &files)
+{
+	for (size_t f = 0; f < files.size(); f++)
+	{
+		result_reader reader;
+		reader.open(files[f].c_str());
+		uint64_t rows = 0;
+		for (unsigned b = 0; b < reader.blocks(); b++)
+			rows += reader.block(b).rows;
+		cout<<files[f]<<": "<<rows<<" rows, "<<reader.blocks()<<" blocks, "
+			<<reader.runs().size()<<" runs, "<<reader.modules().size()<<" modules, "
+			<<reader.metrics().size()<<" metrics\n";
+		for (uint32_t i = 0; i < reader.runs().size(); i++)
+			cout<<"\trun\t"<<reader.runs().name(i)<<"\n";
+		for (uint32_t i = 0; i < reader.metrics().size(); i++)
+			cout<<"\tmetric\t"<<reader.metrics().name(i)<<"\n";
+	}
+	return 0;
+}
+
+static int merge(const string &out, const vector<string> &files)
+{
+	result_writer writer;
+	for (size_t f = 0; f < files.size(); f++)
+	{
+		result_reader reader;
+		reader.open(files[f].c_str());
+		vector<uint32_t> run_id(reader.runs().size()), module_id(reader.modules().size()), metric_id(reader.metrics().size());
+		for (uint32_t i = 0; i < run_id.size(); i++)
+			run_id[i] = writer.runs.id(reader.runs().name(i));
+		for (uint32_t i = 0; i < module_id.size(); i++)
+			module_id[i] = writer.modules.id(reader.modules().name(i));
+		for (uint32_t i = 0; i < metric_id.size(); i++)
+			metric_id[i] = writer.metrics.id(reader.metrics().name(i));
+
+		for (unsigned b = 0; b < reader.blocks(); b++)
+		{
+			const double *value = reader.value_column(b);
+			const uint32_t *run = reader.run_column(b), *module = reader.module_column(b), *metric = reader.metric_column(b);
+			const int32_t *node = reader.node_column(b);
+			for (uint32_t r = 0; r < reader.block(b).rows; r++)
+				writer.add(run_id[run[r]], module_id[module[r]], node[r], metric_id[metric[r]], value[r]);
+		}
+	}
+	writer.write(out.c_str());
+	cout<<writer.size()<<" rows of "<<writer.runs.size()<<" runs written to "<<out<<endl;
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	map<string,string> opt;
+	opt["metric"] = "";		opt["run"] = "";		opt["module"] = "";		opt["node"] = "";
+	opt["by"] = "metric";	opt["files"] = "";		opt["merge"] = "";		opt["list"] = "";
+
+	vector<string> files;
+	for (int i = 1; i < argc; i++){
+		string key(argv[i]);
+		if (key[0] != '-'){
+			files.push_back(key);
+			continue;
+		}
+		if (i+1 >= argc || opt.find(key.substr(1)) == opt.end()){
+			cerr<<"Unknown or incomplete option "<<key<<" (see the header of query_results.cc)"<<endl;
+			return 1;
+		}
+		opt[key.substr(1)] = argv[++i];
+	}
+	if (opt["files"] != ""){
+		ifstream in(opt["files"].c_str());
+		if (!in){
+			cerr<<"Impossible to open "<<opt["files"]<<endl;
+			return 1;
+		}
+		string line;
+		while (getline(in, line))
+			if (!line.empty())
+				files.push_back(line);
+	}
+	if (files.empty()){
+		cerr<<"No result file given"<<endl;
+		return 1;
+	}
+	if (opt["merge"] != "")
+		return merge(opt["merge"], files);
+	if (opt["list"] != "")
+		return list(files);
+
+	vector<int> keys;
+	vector<string> by = split(opt["by"]);
+	for (size_t k = 0; k < by.size(); k++){
+		int key = find(key_names, key_names + NUM_KEYS, by[k]) - key_names;
+		if (key == NUM_KEYS){
+			cerr<<"Unknown grouping key "<<by[k]<<" (run, module, node, metric)"<<endl;
+			return 1;
+		}
+		keys.push_back(key);
+	}
+	bool any_node = opt["node"] == "";
+	int32_t node_filter = atoi(opt["node"].c_str());
+
+	map<vector<string>, aggregate> groups;
+	for (size_t f = 0; f < files.size(); f++)
+	{
+		result_reader reader;
+		reader.open(files[f].c_str());
+
+		// Metric ids to read: one, or all.
+		uint32_t metric_min = 0, metric_max = UINT32_MAX;
+		if (opt["metric"] != ""){
+			int id = reader.metrics().find(opt["metric"]);
+			if (id < 0)
+				continue;
+			metric_min = metric_max = id;
+		}
+		vector<char> run_match = matching(reader.runs(), opt["run"]);
+		vector<char> module_match = matching(reader.modules(), opt["module"]);
+
+		// Groups of this file, by ids.
+		map<array<int64_t,NUM_KEYS>, aggregate> local;
+		for (unsigned b = 0; b < reader.blocks(); b++)
+		{
+			const result_block &blk = reader.block(b);
+			if (blk.metric_max < metric_min || blk.metric_min > metric_max ||
+				!any_in(run_match, blk.run_min, blk.run_max))
+				continue;
+			const double *value = reader.value_column(b);
+			const uint32_t *run = reader.run_column(b), *module = reader.module_column(b), *metric = reader.metric_column(b);
+			const int32_t *node = reader.node_column(b);
+			for (uint32_t r = 0; r < blk.rows; r++)
+			{
+				if (metric[r] < metric_min || metric[r] > metric_max || !run_match[run[r]] ||
+					!module_match[module[r]] || (!any_node && node[r] != node_filter))
+					continue;
+				array<int64_t,NUM_KEYS> id = {{-1, -1, -1, -1}};
+				for (size_t k = 0; k < keys.size(); k++)
+					switch (keys[k]){
+						case BY_RUN: id[k] = run[r]; break;
+						case BY_MODULE: id[k] = module[r]; break;
+						case BY_NODE: id[k] = node[r]; break;
+						case BY_METRIC: id[k] = metric[r]; break;
+					}
+				local[id].add(value[r]);
+			}
+		}
+
+		for (map<array<int64_t,NUM_KEYS>, aggregate>::iterator it = local.begin(); it != local.end(); ++it)
+		{
+			vector<string> name(keys.size());
+			for (size_t k = 0; k < keys.size(); k++)
+				switch (keys[k]){
+					case BY_RUN: name[k] = reader.runs().name(it->first[k]); break;
+					case BY_MODULE: name[k] = reader.modules().name(it->first[k]); break;
+					case BY_NODE: name[k] = to_string(it->first[k]); break;
+					case BY_METRIC: name[k] = reader.metrics().name(it->first[k]); break;
+				}
+			groups[name].merge(it->second);
+		}
+	}
+
+	for (size_t k = 0; k < keys.size(); k++)
+		cout<<key_names[keys[k]]<<"\t";
+	cout<<"count\tmean\tstddev\tmin\tmax\tsum\n";
+	cout.precision(10);
+	for (map<vector<string>, aggregate>::iterator it = groups.begin(); it != groups.end(); ++it)
+	{
+		const aggregate &a = it->second;
+		for (size_t k = 0; k < it->first.size(); k++)
+			cout<<it->first[k]<<"\t";
+		cout<<a.count<<"\t"<<a.mean<<"\t"<<(a.count > 1 ? sqrt(a.m2/(a.count - 1)) : 0)
+			<<"\t"<<a.min<<"\t"<<a.max<<"\t"<<a.sum<<"\n";
+	}
+	return 0;
+}